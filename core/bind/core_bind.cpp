@@ -33,6 +33,7 @@
 #include "core/project_settings.h"
 #include "geometry.h"
 #include "io/marshalls.h"
+#include "message_queue.h"
 #include "os/keyboard.h"
 #include "os/os.h"
 
@@ -78,6 +79,51 @@ RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool
 	return ret;
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_priority);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path) {
+
+	return (ThreadLoadStatus)ResourceLoader::load_threaded_get_status(p_path);
+}
+
+float _ResourceLoader::load_threaded_get_progress(const String &p_path) {
+
+	float progress = 0.0;
+	ResourceLoader::load_threaded_get_status(p_path, &progress);
+	return progress;
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+
+	Error err = OK;
+	RES ret = ResourceLoader::load_threaded_get(p_path, &err);
+
+	if (err != OK) {
+		ERR_EXPLAIN("Error loading resource: '" + p_path + "'");
+		ERR_FAIL_COND_V(err != OK, ret);
+	}
+	return ret;
+}
+
+void _ResourceLoader::_threaded_load_notify(void *p_ud, const String &p_path, const RES &p_resource, Error p_error) {
+
+	// may come from a loading thread, signals are emitted on the main thread
+	_ResourceLoader *self = (_ResourceLoader *)p_ud;
+	if (MessageQueue::get_singleton())
+		MessageQueue::get_singleton()->push_call(self->get_instance_id(), "_threaded_load_done", p_path, p_resource, p_error);
+}
+
+void _ResourceLoader::_threaded_load_done(const String &p_path, const RES &p_resource, int p_error) {
+
+	if (p_error == OK)
+		emit_signal("resource_loaded", p_path, p_resource);
+	else
+		emit_signal("resource_load_failed", p_path, p_error);
+}
+
 PoolVector<String> _ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 
 	List<String> exts;
@@ -123,11 +169,26 @@ void _ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
 	ClassDB::bind_method(D_METHOD("has", "path"), &_ResourceLoader::has);
+
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "priority"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path"), &_ResourceLoader::load_threaded_get_status);
+	ClassDB::bind_method(D_METHOD("load_threaded_get_progress", "path"), &_ResourceLoader::load_threaded_get_progress);
+	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
+	ClassDB::bind_method(D_METHOD("_threaded_load_done"), &_ResourceLoader::_threaded_load_done);
+
+	ADD_SIGNAL(MethodInfo("resource_loaded", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::OBJECT, "resource", PROPERTY_HINT_RESOURCE_TYPE, "Resource")));
+	ADD_SIGNAL(MethodInfo("resource_load_failed", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::INT, "error")));
+
+	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_FAILED);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_LOADED);
 }
 
 _ResourceLoader::_ResourceLoader() {
 
 	singleton = this;
+	ResourceLoader::set_threaded_load_notify_func(this, _threaded_load_notify);
 }
 
 Error _ResourceSaver::save(const String &p_path, const RES &p_resource, uint32_t p_flags) {
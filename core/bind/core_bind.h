@@ -47,10 +47,24 @@ protected:
 	static void _bind_methods();
 	static _ResourceLoader *singleton;
 
+	static void _threaded_load_notify(void *p_ud, const String &p_path, const RES &p_resource, Error p_error);
+	void _threaded_load_done(const String &p_path, const RES &p_resource, int p_error);
+
 public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
 	static _ResourceLoader *get_singleton() { return singleton; }
 	Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "");
 	RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", int p_priority = 0);
+	ThreadLoadStatus load_threaded_get_status(const String &p_path);
+	float load_threaded_get_progress(const String &p_path);
+	RES load_threaded_get(const String &p_path);
 	PoolVector<String> get_recognized_extensions_for_type(const String &p_type);
 	void set_abort_on_missing_resources(bool p_abort);
 	PoolStringArray get_dependencies(const String &p_path);
@@ -84,6 +98,7 @@ public:
 	_ResourceSaver();
 };
 
+VARIANT_ENUM_CAST(_ResourceLoader::ThreadLoadStatus);
 VARIANT_ENUM_CAST(_ResourceSaver::SaverFlags);
 
 class MainLoop;
@@ -31,6 +31,7 @@
 #include "class_db.h"
 
 #include "os/mutex.h"
+#include "safe_refcount.h"
 #include "version.h"
 
 #ifdef NO_THREADS
@@ -251,6 +252,7 @@ MethodDefinition D_METHOD(const char *p_name, const char *p_arg1, const char *p_
 #endif
 
 ClassDB::APIType ClassDB::current_api = API_CORE;
+uint32_t ClassDB::sealed = 0;
 
 void ClassDB::set_current_api(APIType p_api) {
 
@@ -544,6 +546,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	ti.name = name;
 	ti.inherits = p_inherits;
 	ti.api = current_api;
+	atomic_store_release(&sealed, 0);
 
 	if (ti.inherits) {
 
@@ -630,6 +633,17 @@ void ClassDB::get_method_list(StringName p_class, List<MethodInfo> *p_methods, b
 
 MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 
+	if (atomic_load_acquire(&sealed)) {
+
+		// nothing is registered while sealed, the flat tables can be read without the lock
+		ClassInfo *type = classes.getptr(p_class);
+		if (!type)
+			return NULL;
+
+		MethodBind **method = type->flat_method_map.getptr(p_name);
+		return method ? *method : NULL;
+	}
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -660,6 +674,7 @@ void ClassDB::bind_integer_constant(const StringName &p_class, const StringName
 	}
 
 	type->constant_map[p_name] = p_constant;
+	atomic_store_release(&sealed, 0);
 #ifdef DEBUG_METHODS_ENABLED
 
 	String enum_name = p_enum;
@@ -972,6 +987,7 @@ void ClassDB::add_property(StringName p_class, const PropertyInfo &p_pinfo, cons
 	psg.type = p_pinfo.type;
 
 	type->property_setget[p_pinfo.name] = psg;
+	atomic_store_release(&sealed, 0);
 }
 
 void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list, bool p_no_inheritance, const Object *p_validator) {
@@ -998,92 +1014,124 @@ void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list,
 		check = check->inherits_ptr;
 	}
 }
-bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
+bool ClassDB::_lookup_property(const StringName &p_class, const StringName &p_property, PropertyLookup &r_lookup) {
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
-	ClassInfo *check = type;
-	while (check) {
-		const PropertySetGet *psg = check->property_setget.getptr(p_property);
-		if (psg) {
+	if (atomic_load_acquire(&sealed)) {
 
-			if (!psg->setter) {
-				if (r_valid)
-					*r_valid = false;
-				return true; //return true but do nothing
-			}
+		// as in get_method(), lock free while sealed
+		ClassInfo *type = classes.getptr(p_class);
+		const PropertyLookup *pl = type ? type->flat_property_map.getptr(p_property) : NULL;
+		if (!pl)
+			return false;
+		r_lookup = *pl;
+		return true;
+	}
 
-			Variant::CallError ce;
+	OBJTYPE_RLOCK;
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->call(psg->setter, arg, 2, ce);
-				}
+	ClassInfo *type = classes.getptr(p_class);
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->call(psg->setter, arg, 1, ce);
-				}
-			}
+	// same resolution _build_dispatch_tables() flattens
+	r_lookup = PropertyLookup();
+	for (ClassInfo *check = type; check && !(r_lookup.setget && r_lookup.constant); check = check->inherits_ptr) {
 
-			if (r_valid)
-				*r_valid = ce.error == Variant::CallError::CALL_OK;
+		if (!r_lookup.setget)
+			r_lookup.setget = check->property_setget.getptr(p_property);
 
-			return true;
+		if (!r_lookup.constant) {
+			r_lookup.constant = check->constant_map.getptr(p_property);
+			r_lookup.constant_first = r_lookup.constant && !r_lookup.setget;
 		}
-
-		check = check->inherits_ptr;
 	}
 
-	return false;
+	return r_lookup.setget || r_lookup.constant;
 }
-bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
-	ClassInfo *check = type;
-	while (check) {
-		const PropertySetGet *psg = check->property_setget.getptr(p_property);
-		if (psg) {
-			if (!psg->getter)
-				return true; //return true but do nothing
+bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[1] = { &index };
-				Variant::CallError ce;
-				r_value = p_object->call(psg->getter, arg, 1, ce);
+	PropertyLookup pl;
+	if (!_lookup_property(p_object->get_class_name(), p_property, pl))
+		return false;
 
-			} else {
+	const PropertySetGet *psg = pl.setget;
 
-				Variant::CallError ce;
-				if (psg->_getptr) {
+	if (!psg)
+		return false;
 
-					r_value = psg->_getptr->call(p_object, NULL, 0, ce);
-				} else {
-					r_value = p_object->call(psg->getter, NULL, 0, ce);
-				}
-			}
-			return true;
-		}
+	if (!psg->setter) {
+		if (r_valid)
+			*r_valid = false;
+		return true; //return true but do nothing
+	}
 
-		const int *c = check->constant_map.getptr(p_property);
-		if (c) {
+	Variant::CallError ce;
 
-			r_value = *c;
-			return true;
+	if (psg->index >= 0) {
+		Variant index = psg->index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(psg->setter,arg,2,ce);
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->call(psg->setter, arg, 2, ce);
 		}
 
-		check = check->inherits_ptr;
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->call(psg->setter, arg, 1, ce);
+		}
 	}
 
-	return false;
+	if (r_valid)
+		*r_valid = ce.error == Variant::CallError::CALL_OK;
+
+	return true;
+}
+bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
+
+	const PropertySetGet *psg = NULL;
+	const int *c = NULL;
+
+	PropertyLookup pl;
+	if (_lookup_property(p_object->get_class_name(), p_property, pl)) {
+		if (pl.constant && (pl.constant_first || !pl.setget))
+			c = pl.constant;
+		else
+			psg = pl.setget;
+	}
+
+	if (c) {
+
+		r_value = *c;
+		return true;
+	}
+
+	if (!psg)
+		return false;
+
+	if (!psg->getter)
+		return true; //return true but do nothing
+
+	if (psg->index >= 0) {
+		Variant index = psg->index;
+		const Variant *arg[1] = { &index };
+		Variant::CallError ce;
+		r_value = p_object->call(psg->getter, arg, 1, ce);
+
+	} else {
+
+		Variant::CallError ce;
+		if (psg->_getptr) {
+
+			r_value = psg->_getptr->call(p_object, NULL, 0, ce);
+		} else {
+			r_value = p_object->call(psg->getter, NULL, 0, ce);
+		}
+	}
+	return true;
 }
 
 int ClassDB::get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
@@ -1255,6 +1303,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	atomic_store_release(&sealed, 0);
 
 	Vector<Variant> defvals;
 
@@ -1376,6 +1425,69 @@ void ClassDB::get_extensions_for_type(const StringName &p_class, List<String> *p
 	}
 }
 
+void ClassDB::_build_dispatch_tables(ClassInfo *p_class) {
+
+	p_class->flat_method_map.clear();
+	p_class->flat_property_map.clear();
+
+	// go from the class up to the root, so the closest declaration wins
+	for (ClassInfo *check = p_class; check; check = check->inherits_ptr) {
+
+		const StringName *K = NULL;
+		while ((K = check->method_map.next(K))) {
+
+			MethodBind *method = check->method_map[*K];
+			if (method && !p_class->flat_method_map.has(*K))
+				p_class->flat_method_map[*K] = method;
+		}
+
+		K = NULL;
+		while ((K = check->property_setget.next(K))) {
+
+			PropertyLookup &pl = p_class->flat_property_map[*K];
+			if (!pl.setget)
+				pl.setget = check->property_setget.getptr(*K);
+		}
+
+		K = NULL;
+		while ((K = check->constant_map.next(K))) {
+
+			PropertyLookup &pl = p_class->flat_property_map[*K];
+			if (!pl.constant) {
+				pl.constant = check->constant_map.getptr(*K);
+				pl.constant_first = pl.setget == NULL;
+			}
+		}
+	}
+}
+
+void ClassDB::seal() {
+
+	OBJTYPE_WLOCK;
+
+	const StringName *k = NULL;
+
+	while ((k = classes.next(k))) {
+
+		_build_dispatch_tables(&classes[*k]);
+	}
+
+	// the tables are complete before lock free readers can see the flag
+	atomic_store_release(&sealed, 1);
+}
+
+void ClassDB::unseal() {
+
+	OBJTYPE_WLOCK;
+
+	atomic_store_release(&sealed, 0);
+}
+
+bool ClassDB::is_sealed() {
+
+	return atomic_load_acquire(&sealed) != 0;
+}
+
 RWLock *ClassDB::lock = NULL;
 
 void ClassDB::init() {
@@ -1402,6 +1514,7 @@ void ClassDB::cleanup() {
 			memdelete(ti.method_map[*m]);
 		}
 	}
+	atomic_store_release(&sealed, 0);
 	classes.clear();
 	resource_base_extensions.clear();
 	compat_classes.clear();
@@ -110,11 +110,23 @@ public:
 		Variant::Type type;
 	};
 
+	struct PropertyLookup {
+		const PropertySetGet *setget;
+		const int *constant;
+		bool constant_first; // constant is declared closer to the class than setget
+
+		PropertyLookup() {
+			setget = NULL;
+			constant = NULL;
+			constant_first = false;
+		}
+	};
+
 	struct ClassInfo {
 
 		APIType api;
 		ClassInfo *inherits_ptr;
-		HashMap<StringName, MethodBind *, StringNameHasher> method_map;
+		OAHashMap<StringName, MethodBind *, StringNameHasher> method_map;
 		HashMap<StringName, int, StringNameHasher> constant_map;
 		HashMap<StringName, MethodInfo, StringNameHasher> signal_map;
 		List<PropertyInfo> property_list;
@@ -128,6 +140,11 @@ public:
 #endif
 		HashMap<StringName, PropertySetGet, StringNameHasher> property_setget;
 
+		// Lookups including inherited entries, so dispatch does not walk
+		// the inheritance chain. Only valid while the ClassDB is sealed.
+		OAHashMap<StringName, MethodBind *, StringNameHasher> flat_method_map;
+		OAHashMap<StringName, PropertyLookup, StringNameHasher> flat_property_map;
+
 		StringName inherits;
 		StringName name;
 		bool disabled;
@@ -154,8 +171,13 @@ public:
 #endif
 
 	static APIType current_api;
+	// Set by seal() once the flat tables are built, lookups then skip the lock. Registering
+	// anything unseals first, which is only expected while no other thread looks things up.
+	static uint32_t sealed;
 
 	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
+	static void _build_dispatch_tables(ClassInfo *p_class);
+	static bool _lookup_property(const StringName &p_class, const StringName &p_property, PropertyLookup &r_lookup);
 
 public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
@@ -306,6 +328,7 @@ public:
 			ERR_FAIL_V(NULL);
 		}
 		type->method_map[p_name] = bind;
+		unseal(); // flips the flag under the ClassDB lock
 #ifdef DEBUG_METHODS_ENABLED
 		// FIXME: <reduz> set_return_type is no longer in MethodBind, so I guess it should be moved to vararg method bind
 		//bind->set_return_type("Variant");
@@ -365,6 +388,11 @@ public:
 	static void init();
 
 	static void set_current_api(APIType p_api);
+
+	static void seal();
+	static void unseal();
+	static bool is_sealed();
+
 	static void cleanup();
 };
 
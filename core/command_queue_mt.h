@@ -448,6 +448,14 @@ public:
 		flush_one();
 	}
 
+	bool is_empty() {
+
+		lock();
+		bool empty = read_ptr == write_ptr;
+		unlock();
+		return empty;
+	}
+
 	void flush_all() {
 
 		//ERR_FAIL_COND(sync);
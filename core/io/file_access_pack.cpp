@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "file_access_pack.h"
+#include "os/copymem.h"
 #include "version.h"
 
 #include <stdio.h>
@@ -92,6 +93,31 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	}
 }
 
+bool PackedData::add_mapped_pack(const String &p_path, FileAccess *p_file) {
+
+	// a pack added twice keeps its first mapping, open files may point into it
+	if (mapped_packs.has(p_path))
+		return false;
+
+	const uint8_t *data = p_file->get_mapped_region();
+	if (!data)
+		return false;
+
+	MappedPack mp;
+	mp.file = p_file;
+	mp.data = data;
+	mapped_packs[p_path] = mp;
+	return true;
+}
+
+const uint8_t *PackedData::get_mapped_pack(const String &p_path) const {
+
+	const Map<String, MappedPack>::Element *E = mapped_packs.find(p_path);
+	if (!E)
+		return NULL;
+	return E->get().data;
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 
 	if (p_source != NULL) {
@@ -123,6 +149,9 @@ PackedData::~PackedData() {
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
+	for (Map<String, MappedPack>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		memdelete(E->get().file);
+	}
 	_free_packed_dirs(root);
 }
 
@@ -196,6 +225,11 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
 	};
 
+	// keep the whole pack mapped when the platform allows it
+	if (!PackedData::get_singleton()->add_mapped_pack(p_path, f)) {
+		memdelete(f);
+	}
+
 	return true;
 };
 
@@ -214,12 +248,21 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
-	f->close();
+	if (mapped) {
+		mapped = NULL;
+		return;
+	}
+
+	if (f)
+		f->close();
 }
 
 bool FileAccessPack::is_open() const {
 
-	return f->is_open();
+	if (mapped)
+		return true;
+
+	return f && f->is_open();
 }
 
 void FileAccessPack::seek(size_t p_position) {
@@ -230,7 +273,8 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (!mapped)
+		f->seek(pf.offset + p_position);
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -258,6 +302,9 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped)
+		return mapped[pos++];
+
 	pos++;
 	return f->get_8();
 }
@@ -273,18 +320,30 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		copymem(p_dst, &mapped[from], to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_region() const {
+
+	return mapped;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f)
+		f->set_endian_swap(p_swap);
 }
 
 Error FileAccessPack::get_error() const {
@@ -316,14 +375,24 @@ bool FileAccessPack::file_exists(const String &p_name) {
 
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(NULL),
+		mapped(NULL) {
+
+	pos = 0;
+	eof = false;
+
+	const uint8_t *pack_data = PackedData::get_singleton()->get_mapped_pack(pf.pack);
+	if (pack_data) {
+		mapped = pack_data + pf.offset;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
 		ERR_FAIL_COND(!f);
 	}
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -90,6 +90,15 @@ private:
 
 	Map<PathMD5, PackedFile> files;
 
+	// packs kept open and mapped in memory, files inside are read from them
+	// directly instead of opening the pack again
+	struct MappedPack {
+		FileAccess *file;
+		const uint8_t *data;
+	};
+
+	Map<String, MappedPack> mapped_packs;
+
 	Vector<PackSource *> sources;
 
 	PackedDir *root;
@@ -103,6 +112,8 @@ private:
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	bool add_mapped_pack(const String &p_path, FileAccess *p_file); // for PackSource, takes the file if it can be mapped
+	const uint8_t *get_mapped_pack(const String &p_path) const;
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -140,6 +151,7 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *mapped; // file contents when the pack is mapped, f is not used then
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -157,6 +169,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_mapped_region() const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -35,6 +35,7 @@
 #include "path_remap.h"
 #include "print_string.h"
 #include "project_settings.h"
+#include "safe_refcount.h"
 #include "variant_parser.h"
 ResourceFormatLoader *ResourceLoader::loader[MAX_LOADERS];
 
@@ -205,24 +206,484 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 		return RES(ResourceCache::get(local_path));
 	}
 
+	if (!p_no_cache && thread_load_task_count > 0) {
+		// requested in the background too, don't load it twice
+		RES res;
+		if (_thread_load_wait(local_path, res, r_error))
+			return res;
+	}
+
 	String path = local_path;
 
 	ERR_FAIL_COND_V(path == "", RES());
 
+	bool claimed = false;
+	if (!p_no_cache) {
+		// another thread may be loading it too, e.g. a dependency both share
+		RES res;
+		if (_thread_load_begin(local_path, res, claimed)) {
+			if (r_error)
+				*r_error = OK;
+			return res;
+		}
+	}
+
 	if (OS::get_singleton()->is_stdout_verbose())
 		print_line("load resource: " + path);
 
 	RES res = _load(path, local_path, p_type_hint, p_no_cache, r_error);
 
+	if (res.is_valid() && !p_no_cache)
+		res->set_path(local_path);
+
+	if (claimed)
+		_thread_load_end(local_path); // after set_path(), so waiting threads find it cached
+
 	if (res.is_null()) {
 		return RES();
 	}
-	if (!p_no_cache)
-		res->set_path(local_path);
 
 	return res;
 }
 
+void ResourceLoader::_thread_load_function(void *p_userdata) {
+
+	while (true) {
+
+		thread_load_semaphore->wait();
+		if (thread_load_exit)
+			break;
+
+		thread_load_mutex->lock();
+		ThreadLoadTask *task = _thread_load_pick();
+		if (task) {
+			task->running = true;
+			task->running_thread = Thread::get_caller_id();
+		}
+		thread_load_mutex->unlock();
+
+		if (task)
+			_thread_load_step(task, 0);
+	}
+
+	// lets finalize_threaded_loading() stop servicing the main thread's queues
+	atomic_decrement(&thread_load_running);
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
+
+	String local_path = p_path.is_rel_path() ? "res://" + p_path : ProjectSettings::get_singleton()->localize_path(p_path);
+
+	if (!thread_load_mutex)
+		return THREAD_LOAD_INVALID_RESOURCE;
+
+	thread_load_mutex->lock();
+
+	ThreadLoadStatus status = THREAD_LOAD_INVALID_RESOURCE;
+	const ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (task) {
+		status = task->status;
+		if (r_progress)
+			*r_progress = task->progress;
+	}
+
+	thread_load_mutex->unlock();
+
+	return status;
+}
+
+ResourceLoader::ThreadLoadTask *ResourceLoader::_thread_load_pick() {
+
+	// highest priority first, then in request order
+	ThreadLoadTask *best = NULL;
+
+	const String *k = NULL;
+	while ((k = thread_load_tasks.next(k))) {
+
+		ThreadLoadTask *task = thread_load_tasks.getptr(*k);
+		if (task->status != THREAD_LOAD_IN_PROGRESS || task->running)
+			continue;
+
+		if (!best || task->priority > best->priority || (task->priority == best->priority && task->order < best->order))
+			best = task;
+	}
+
+	return best;
+}
+
+bool ResourceLoader::_thread_load_step(ThreadLoadTask *p_task, uint64_t p_until_usec) {
+
+	// the task is marked as running by this thread, so its loader is not touched by anyone else
+
+	Error err = OK;
+
+	if (p_task->loader.is_null()) {
+		// wait for a thread loading it as a dependency, it's cached then
+		RES loaded;
+		bool claimed;
+		_thread_load_begin(p_task->local_path, loaded, claimed);
+		if (claimed)
+			_thread_load_end(p_task->local_path);
+
+		p_task->loader = load_interactive(p_task->local_path, p_task->type_hint, false, &err);
+		if (p_task->loader.is_null() && err == OK)
+			err = ERR_CANT_OPEN;
+	}
+
+	if (p_task->loader.is_valid()) {
+
+		while (true) {
+
+			err = p_task->loader->poll();
+			if (err != OK)
+				break;
+
+			int stage_count = p_task->loader->get_stage_count();
+			thread_load_mutex->lock();
+			p_task->progress = stage_count > 0 ? float(p_task->loader->get_stage()) / stage_count : 0.0;
+			thread_load_mutex->unlock();
+
+			if (thread_load_exit) {
+				err = ERR_SKIP;
+				break;
+			}
+
+			if (p_until_usec && OS::get_singleton()->get_ticks_usec() >= p_until_usec) {
+				// out of time for this frame, continue on the next one
+				thread_load_mutex->lock();
+				p_task->running = false;
+				thread_load_mutex->unlock();
+				return false;
+			}
+		}
+	}
+
+	RES res;
+	if (err == ERR_FILE_EOF) {
+		res = p_task->loader->get_resource();
+		err = res.is_valid() ? OK : ERR_CANT_ACQUIRE_RESOURCE;
+	}
+	p_task->loader.unref();
+
+	thread_load_mutex->lock();
+	String path = p_task->local_path;
+	p_task->resource = res;
+	p_task->error = err;
+	p_task->progress = 1.0;
+	p_task->status = err == OK ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+	p_task->running = false;
+	thread_load_mutex->unlock();
+
+	if (err != OK && err != ERR_SKIP)
+		ERR_PRINTS("Failed loading resource in the background: " + path);
+
+	if (thread_load_notify)
+		thread_load_notify(thread_load_notify_ud, path, res, err);
+
+	return true;
+}
+
+void ResourceLoader::_thread_load_wait_step() {
+
+	// the loading thread may be blocked on a server call only the main thread can complete
+	if (thread_load_wait_func && Thread::get_caller_id() == Thread::get_main_id())
+		thread_load_wait_func();
+
+	OS::get_singleton()->delay_usec(1000);
+}
+
+Thread::ID ResourceLoader::_thread_load_owner(const String &p_local_path) {
+
+	const Thread::ID *owner = thread_load_paths.getptr(p_local_path);
+	if (owner)
+		return *owner;
+
+	const ThreadLoadTask *task = thread_load_tasks.getptr(p_local_path);
+	if (task && task->status == THREAD_LOAD_IN_PROGRESS && task->running)
+		return task->running_thread;
+
+	return 0;
+}
+
+bool ResourceLoader::_thread_load_would_deadlock(Thread::ID p_owner) {
+
+	// follow what the owner is waiting for, coming back to this thread is a cycle
+	Thread::ID id = Thread::get_caller_id();
+	Thread::ID owner = p_owner;
+
+	for (int i = 0; owner && i <= thread_load_waiting.size(); i++) {
+
+		if (owner == id)
+			return true;
+
+		const String *path = thread_load_waiting.getptr(owner);
+		if (!path)
+			return false;
+
+		owner = _thread_load_owner(*path);
+	}
+
+	return false;
+}
+
+bool ResourceLoader::_thread_load_begin(const String &p_local_path, RES &r_resource, bool &r_claimed) {
+
+	r_claimed = false;
+
+	if (!thread_load_mutex)
+		return false;
+
+	Thread::ID id = Thread::get_caller_id();
+
+	thread_load_mutex->lock();
+
+	while (true) {
+
+		if (ResourceCache::has(p_local_path)) {
+			// loaded by the thread that was waited for
+			r_resource = RES(ResourceCache::get(p_local_path));
+			thread_load_mutex->unlock();
+			return true;
+		}
+
+		const Thread::ID *owner = thread_load_paths.getptr(p_local_path);
+		if (!owner) {
+			thread_load_paths[p_local_path] = id;
+			r_claimed = true;
+			break;
+		}
+
+		if (_thread_load_would_deadlock(*owner))
+			break; // cyclic dependency, load it here unclaimed like before
+
+		thread_load_waiting[id] = p_local_path;
+		thread_load_mutex->unlock();
+		_thread_load_wait_step();
+		thread_load_mutex->lock();
+		thread_load_waiting.erase(id);
+	}
+
+	thread_load_mutex->unlock();
+	return false;
+}
+
+void ResourceLoader::_thread_load_end(const String &p_local_path) {
+
+	thread_load_mutex->lock();
+	thread_load_paths.erase(p_local_path);
+	thread_load_mutex->unlock();
+}
+
+bool ResourceLoader::_thread_load_wait(const String &p_local_path, RES &r_resource, Error *r_error) {
+
+	if (!thread_load_mutex)
+		return false;
+
+	thread_load_mutex->lock();
+
+	while (true) {
+
+		ThreadLoadTask *task = thread_load_tasks.getptr(p_local_path);
+		if (!task || task->status == THREAD_LOAD_FAILED) {
+			break;
+		}
+
+		if (task->status == THREAD_LOAD_LOADED) {
+			r_resource = task->resource;
+			if (r_error)
+				*r_error = OK;
+			thread_load_mutex->unlock();
+			return true;
+		}
+
+		if (!task->running) {
+			// not picked up yet (or parked between frames), load it here
+			task->running = true;
+			task->running_thread = Thread::get_caller_id();
+			thread_load_mutex->unlock();
+			_thread_load_step(task, 0);
+			thread_load_mutex->lock();
+			continue;
+		}
+
+		if (_thread_load_would_deadlock(task->running_thread)) {
+			break; // loading it already, this is a cyclic dependency
+		}
+
+		thread_load_waiting[Thread::get_caller_id()] = p_local_path;
+		thread_load_mutex->unlock();
+		_thread_load_wait_step();
+		thread_load_mutex->lock();
+		thread_load_waiting.erase(Thread::get_caller_id());
+	}
+
+	thread_load_mutex->unlock();
+	return false;
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	ERR_FAIL_COND_V(!thread_load_mutex, ERR_UNAVAILABLE);
+
+	String local_path = p_path.is_rel_path() ? "res://" + p_path : ProjectSettings::get_singleton()->localize_path(p_path);
+	ERR_FAIL_COND_V(local_path == "", ERR_INVALID_PARAMETER);
+
+	thread_load_mutex->lock();
+
+	if (!thread_load_initialized) {
+		thread_load_initialized = true;
+
+		int thread_count = GLOBAL_DEF("threading/resource_loader/max_threads", DEFAULT_LOAD_THREADS);
+#ifdef NO_THREADS
+		thread_count = 0;
+#endif
+		if (OS::get_singleton()->get_render_thread_mode() == OS::RENDER_THREAD_UNSAFE) {
+			// the renderer must only be called from the main thread, load there in slices instead
+			thread_count = 0;
+		}
+
+		thread_load_running = thread_count;
+		for (int i = 0; i < thread_count; i++) {
+			thread_load_threads.push_back(Thread::create(_thread_load_function, NULL));
+		}
+	}
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (task) {
+		task->priority = MAX(task->priority, p_priority);
+		thread_load_mutex->unlock();
+		return OK;
+	}
+
+	ThreadLoadTask new_task;
+	new_task.local_path = local_path;
+	new_task.type_hint = p_type_hint;
+	new_task.priority = p_priority;
+	new_task.order = thread_load_order++;
+	new_task.progress = 0.0;
+	new_task.running = false;
+	new_task.running_thread = 0;
+	new_task.error = OK;
+
+	if (ResourceCache::has(local_path)) {
+		// loaded already, or through another request's dependencies
+		new_task.resource = RES(ResourceCache::get(local_path));
+		new_task.status = THREAD_LOAD_LOADED;
+		new_task.progress = 1.0;
+	} else {
+		new_task.status = THREAD_LOAD_IN_PROGRESS;
+	}
+
+	thread_load_tasks[local_path] = new_task;
+	thread_load_task_count = thread_load_tasks.size();
+
+	thread_load_mutex->unlock();
+
+	if (new_task.status == THREAD_LOAD_IN_PROGRESS && thread_load_threads.size()) {
+		thread_load_semaphore->post();
+	} else if (new_task.status == THREAD_LOAD_LOADED && thread_load_notify) {
+		thread_load_notify(thread_load_notify_ud, local_path, new_task.resource, OK);
+	}
+
+	return OK;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+
+	if (r_error)
+		*r_error = ERR_INVALID_PARAMETER;
+
+	ERR_FAIL_COND_V(!thread_load_mutex, RES());
+
+	String local_path = p_path.is_rel_path() ? "res://" + p_path : ProjectSettings::get_singleton()->localize_path(p_path);
+
+	// finishes the load on this thread if nobody picked it up yet
+	RES res;
+	_thread_load_wait(local_path, res, NULL);
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (!task || task->status == THREAD_LOAD_IN_PROGRESS) {
+		thread_load_mutex->unlock();
+		ERR_EXPLAIN("Resource was not requested for background loading: " + local_path);
+		ERR_FAIL_COND_V(!task, RES());
+		ERR_FAIL_V(RES());
+	}
+
+	res = task->resource;
+	if (r_error)
+		*r_error = task->error;
+
+	thread_load_tasks.erase(local_path);
+	thread_load_task_count = thread_load_tasks.size();
+
+	thread_load_mutex->unlock();
+
+	return res;
+}
+
+void ResourceLoader::poll_threaded_loads() {
+
+	// only does work when there are no loading threads, see load_threaded_request()
+	if (thread_load_task_count == 0 || thread_load_threads.size())
+		return;
+
+	uint64_t until = OS::get_singleton()->get_ticks_usec() + MAIN_THREAD_LOAD_BUDGET_USEC;
+
+	while (OS::get_singleton()->get_ticks_usec() < until) {
+
+		thread_load_mutex->lock();
+		ThreadLoadTask *task = _thread_load_pick();
+		if (task) {
+			task->running = true;
+			task->running_thread = Thread::get_caller_id();
+		}
+		thread_load_mutex->unlock();
+
+		if (!task || !_thread_load_step(task, until))
+			break;
+	}
+}
+
+void ResourceLoader::initialize_threaded_loading() {
+
+	thread_load_mutex = Mutex::create();
+	thread_load_semaphore = Semaphore::create();
+}
+
+void ResourceLoader::finalize_threaded_loading() {
+
+	if (!thread_load_mutex)
+		return;
+
+	thread_load_exit = true;
+	for (int i = 0; i < thread_load_threads.size(); i++) {
+		thread_load_semaphore->post();
+	}
+	while (atomic_add(&thread_load_running, (uint32_t)0)) {
+		// a step in progress can't be joined until the calls it's blocked on are serviced
+		_thread_load_wait_step();
+	}
+	for (int i = 0; i < thread_load_threads.size(); i++) {
+		Thread::wait_to_finish(thread_load_threads[i]);
+		memdelete(thread_load_threads[i]);
+	}
+	thread_load_threads.clear();
+
+	thread_load_tasks.clear();
+	thread_load_task_count = 0;
+	thread_load_paths.clear();
+	thread_load_waiting.clear();
+
+	memdelete(thread_load_mutex);
+	thread_load_mutex = NULL;
+	if (thread_load_semaphore) {
+		memdelete(thread_load_semaphore);
+		thread_load_semaphore = NULL;
+	}
+}
+
 Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
 	if (r_error)
@@ -443,3 +904,18 @@ bool ResourceLoader::timestamp_on_load = false;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, String> ResourceLoader::path_remaps;
+
+Mutex *ResourceLoader::thread_load_mutex = NULL;
+Semaphore *ResourceLoader::thread_load_semaphore = NULL;
+Vector<Thread *> ResourceLoader::thread_load_threads;
+HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
+HashMap<String, Thread::ID> ResourceLoader::thread_load_paths;
+HashMap<Thread::ID, String> ResourceLoader::thread_load_waiting;
+volatile int ResourceLoader::thread_load_task_count = 0;
+uint64_t ResourceLoader::thread_load_order = 0;
+volatile bool ResourceLoader::thread_load_exit = false;
+uint32_t ResourceLoader::thread_load_running = 0;
+bool ResourceLoader::thread_load_initialized = false;
+void *ResourceLoader::thread_load_notify_ud = NULL;
+ThreadedLoadNotify ResourceLoader::thread_load_notify = NULL;
+ThreadedLoadWaitFunc ResourceLoader::thread_load_wait_func = NULL;
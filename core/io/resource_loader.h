@@ -31,6 +31,9 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
 #include "resource.h"
 
 /**
@@ -74,11 +77,37 @@ public:
 
 typedef void (*ResourceLoadErrorNotify)(void *p_ud, const String &p_text);
 typedef void (*DependencyErrorNotify)(void *p_ud, const String &p_loading, const String &p_which, const String &p_type);
+typedef void (*ThreadedLoadNotify)(void *p_ud, const String &p_path, const RES &p_resource, Error p_error);
+typedef void (*ThreadedLoadWaitFunc)();
 
 class ResourceLoader {
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
 
+private:
 	enum {
-		MAX_LOADERS = 64
+		MAX_LOADERS = 64,
+		DEFAULT_LOAD_THREADS = 2,
+		MAIN_THREAD_LOAD_BUDGET_USEC = 4000
+	};
+
+	struct ThreadLoadTask {
+		String local_path;
+		String type_hint;
+		int priority;
+		uint64_t order;
+		ThreadLoadStatus status;
+		float progress;
+		bool running; // being polled by running_thread, nobody else touches loader
+		Thread::ID running_thread;
+		Ref<ResourceInteractiveLoader> loader; // kept between frames when loading on the main thread
+		RES resource;
+		Error error;
 	};
 
 	static ResourceFormatLoader *loader[MAX_LOADERS];
@@ -97,6 +126,31 @@ class ResourceLoader {
 
 	static SelfList<Resource>::List remapped_list;
 
+	static Mutex *thread_load_mutex;
+	static Semaphore *thread_load_semaphore;
+	static Vector<Thread *> thread_load_threads;
+	static HashMap<String, ThreadLoadTask> thread_load_tasks;
+	static HashMap<String, Thread::ID> thread_load_paths; // being loaded by load(), and by which thread
+	static HashMap<Thread::ID, String> thread_load_waiting; // path each thread waits for, to detect cycles
+	static volatile int thread_load_task_count;
+	static uint64_t thread_load_order;
+	static volatile bool thread_load_exit;
+	static uint32_t thread_load_running;
+	static bool thread_load_initialized;
+	static void *thread_load_notify_ud;
+	static ThreadedLoadNotify thread_load_notify;
+	static ThreadedLoadWaitFunc thread_load_wait_func;
+
+	static void _thread_load_function(void *p_userdata);
+	static ThreadLoadTask *_thread_load_pick();
+	static bool _thread_load_step(ThreadLoadTask *p_task, uint64_t p_until_usec);
+	static bool _thread_load_wait(const String &p_local_path, RES &r_resource, Error *r_error);
+	static void _thread_load_wait_step();
+	static Thread::ID _thread_load_owner(const String &p_local_path);
+	static bool _thread_load_would_deadlock(Thread::ID p_owner);
+	static bool _thread_load_begin(const String &p_local_path, RES &r_resource, bool &r_claimed);
+	static void _thread_load_end(const String &p_local_path);
+
 	friend class ResourceFormatImporter;
 	//internal load function
 	static RES _load(const String &p_path, const String &p_original_path, const String &p_type_hint, bool p_no_cache, Error *r_error);
@@ -105,6 +159,25 @@ public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 
+	// Background loading, resources are loaded by worker threads (or on the main thread in slices, when
+	// the renderer can't be called from other threads) and picked up once done.
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", int p_priority = 0);
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = NULL);
+	static RES load_threaded_get(const String &p_path, Error *r_error = NULL);
+	static void poll_threaded_loads();
+
+	static void set_threaded_load_notify_func(void *p_ud, ThreadedLoadNotify p_notify) {
+		thread_load_notify = p_notify;
+		thread_load_notify_ud = p_ud;
+	}
+
+	// Called on the main thread while it waits for the loading threads, which may themselves be blocked
+	// on the main thread, e.g. on a synchronous call to a server that only runs queued commands there.
+	static void set_threaded_load_wait_func(ThreadedLoadWaitFunc p_func) { thread_load_wait_func = p_func; }
+
+	static void initialize_threaded_loading();
+	static void finalize_threaded_loading(); // before format loaders go away, waits for the loading threads
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(ResourceFormatLoader *p_format_loader, bool p_at_front = false);
 	static String get_resource_type(const String &p_path);
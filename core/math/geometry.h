@@ -771,7 +771,7 @@ public:
 	static Vector<int> triangulate_polygon(const Vector<Vector2> &p_polygon) {
 
 		Vector<int> triangles;
-		if (!Triangulate::triangulate(p_polygon, triangles))
+		if (!Triangulate::triangulate_monotone(p_polygon, triangles))
 			return Vector<int>(); //fail
 		return triangles;
 	}
@@ -30,6 +30,9 @@
 
 #include "triangulate.h"
 
+#include "map.h"
+#include "sort.h"
+
 real_t Triangulate::get_area(const Vector<Vector2> &contour) {
 
 	int n = contour.size();
@@ -167,3 +170,467 @@ bool Triangulate::triangulate(const Vector<Vector2> &contour, Vector<int> &resul
 
 	return true;
 }
+
+/*
+   Monotone partition, see "Computational Geometry: Algorithms and
+   Applications" (de Berg et al.), chapter 3. The sweep runs from the highest
+   vertex down, vertices at the same height are visited left to right.
+   */
+
+static _FORCE_INLINE_ bool _is_above(const Vector2 &a, const Vector2 &b) {
+
+	return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+struct _MonotoneSweepOrder {
+
+	const Vector2 *points;
+
+	bool operator()(int a, int b) const { return _is_above(points[a], points[b]); }
+};
+
+struct _MonotoneSweep {
+
+	const Vector2 *points;
+	int count;
+	Vector2 pos;
+};
+
+// an edge crossed by the sweep line, going down from points[from] to the
+// next point. from == -1 stands for the sweep position itself, for lookups.
+struct _MonotoneEdge {
+
+	const _MonotoneSweep *sweep;
+	int from;
+
+	real_t get_x() const {
+
+		if (from < 0)
+			return sweep->pos.x;
+
+		const Vector2 &a = sweep->points[from];
+		const Vector2 &b = sweep->points[(from + 1) % sweep->count];
+		if (a.y == b.y)
+			return MAX(a.x, b.x);
+		return a.x + (b.x - a.x) * (sweep->pos.y - a.y) / (b.y - a.y);
+	}
+
+	real_t get_spread() const {
+
+		const Vector2 &a = sweep->points[from];
+		const Vector2 &b = sweep->points[(from + 1) % sweep->count];
+		if (a.y == b.y)
+			return 1e20;
+		return (b.x - a.x) / (a.y - b.y);
+	}
+
+	bool operator<(const _MonotoneEdge &p_edge) const {
+
+		if (from == p_edge.from)
+			return false;
+
+		real_t x = get_x();
+		real_t other_x = p_edge.get_x();
+		if (x != other_x)
+			return x < other_x;
+
+		// an edge touching the sweep position counts as left of it
+		if (from < 0)
+			return false;
+		if (p_edge.from < 0)
+			return true;
+
+		// edges meeting at the sweep line, order them by where they go below it
+		real_t spread = get_spread();
+		real_t other_spread = p_edge.get_spread();
+		if (spread != other_spread)
+			return spread < other_spread;
+
+		return from < p_edge.from;
+	}
+
+	_MonotoneEdge() {
+		sweep = NULL;
+		from = -1;
+	}
+};
+
+bool Triangulate::_triangulate_monotone_piece(const Vector2 *p_points, const Vector<int> &p_piece, Vector<int> &r_triangles) {
+
+	int n = p_piece.size();
+	if (n < 3)
+		return false;
+
+	const int *piece = p_piece.ptr();
+
+	if (n == 3) {
+		r_triangles.push_back(piece[0]);
+		r_triangles.push_back(piece[1]);
+		r_triangles.push_back(piece[2]);
+		return true;
+	}
+
+	int top = 0;
+	int bottom = 0;
+	for (int i = 1; i < n; i++) {
+		if (_is_above(p_points[piece[i]], p_points[piece[top]]))
+			top = i;
+		if (_is_above(p_points[piece[bottom]], p_points[piece[i]]))
+			bottom = i;
+	}
+
+	// merge both chains into sweep order, going counter-clockwise from the
+	// top walks down the left chain
+	Vector<int> sorted;
+	Vector<bool> left;
+	sorted.resize(n);
+	left.resize(n);
+
+	sorted[0] = piece[top];
+	left[0] = true;
+
+	int l = (top + 1) % n;
+	int r = (top + n - 1) % n;
+	for (int i = 1; i < n - 1; i++) {
+
+		bool take_left;
+		if (l == bottom)
+			take_left = false;
+		else if (r == bottom)
+			take_left = true;
+		else
+			take_left = _is_above(p_points[piece[l]], p_points[piece[r]]);
+
+		if (take_left) {
+			sorted[i] = piece[l];
+			l = (l + 1) % n;
+		} else {
+			sorted[i] = piece[r];
+			r = (r + n - 1) % n;
+		}
+		left[i] = take_left;
+	}
+
+	if (l != bottom || r != bottom)
+		return false; //not a simple loop
+
+	sorted[n - 1] = piece[bottom];
+	left[n - 1] = true;
+
+	// stack holds positions in sorted
+	Vector<int> stack;
+	stack.push_back(0);
+	stack.push_back(1);
+
+	for (int j = 2; j < n - 1; j++) {
+
+		int current = sorted[j];
+
+		if (left[j] != left[stack[stack.size() - 1]]) {
+
+			for (int k = stack.size() - 1; k > 0; k--) {
+				r_triangles.push_back(current);
+				r_triangles.push_back(sorted[stack[k]]);
+				r_triangles.push_back(sorted[stack[k - 1]]);
+			}
+			stack.clear();
+			stack.push_back(j - 1);
+			stack.push_back(j);
+
+		} else {
+
+			int last = stack[stack.size() - 1];
+			stack.resize(stack.size() - 1);
+
+			while (stack.size()) {
+
+				int top_pos = stack[stack.size() - 1];
+				const Vector2 &c = p_points[current];
+				real_t turn = (p_points[sorted[last]] - c).cross(p_points[sorted[top_pos]] - c);
+				if (left[j] ? turn >= 0 : turn <= 0)
+					break;
+
+				r_triangles.push_back(current);
+				r_triangles.push_back(sorted[last]);
+				r_triangles.push_back(sorted[top_pos]);
+				last = top_pos;
+				stack.resize(stack.size() - 1);
+			}
+
+			stack.push_back(last);
+			stack.push_back(j);
+		}
+	}
+
+	int current = sorted[n - 1];
+	for (int k = stack.size() - 1; k > 0; k--) {
+		r_triangles.push_back(current);
+		r_triangles.push_back(sorted[stack[k]]);
+		r_triangles.push_back(sorted[stack[k - 1]]);
+	}
+
+	return true;
+}
+
+bool Triangulate::triangulate_monotone(const Vector<Vector2> &contour, Vector<int> &result) {
+
+	int n = contour.size();
+	if (n < 3)
+		return false;
+
+	real_t area = get_area(contour);
+	if (area == 0)
+		return triangulate(contour, result);
+
+	/* work on a counter-clockwise copy, V maps back to the contour */
+
+	Vector<Vector2> ccw;
+	Vector<int> V;
+	ccw.resize(n);
+	V.resize(n);
+	for (int i = 0; i < n; i++) {
+		V[i] = area > 0 ? i : (n - 1) - i;
+		ccw[i] = contour[V[i]];
+	}
+	const Vector2 *points = ccw.ptr();
+
+	Vector<int> order;
+	order.resize(n);
+	for (int i = 0; i < n; i++)
+		order[i] = i;
+
+	SortArray<int, _MonotoneSweepOrder> sorter;
+	sorter.compare.points = points;
+	sorter.sort(order.ptrw(), n);
+
+	for (int i = 1; i < n; i++) {
+		if (points[order[i - 1]] == points[order[i]])
+			return triangulate(contour, result); //repeated points
+	}
+
+	/* sweep, collecting the diagonals that split the contour into monotone pieces */
+
+	enum VertexType {
+		VERTEX_START,
+		VERTEX_END,
+		VERTEX_SPLIT,
+		VERTEX_MERGE,
+		VERTEX_REGULAR_LEFT, // interior to the right
+		VERTEX_REGULAR_RIGHT,
+	};
+
+	Vector<int> types;
+	types.resize(n);
+	for (int i = 0; i < n; i++) {
+
+		int prev = (i + n - 1) % n;
+		int next = (i + 1) % n;
+		bool prev_below = _is_above(points[i], points[prev]);
+		bool next_below = _is_above(points[i], points[next]);
+		bool convex = (points[i] - points[prev]).cross(points[next] - points[i]) > 0;
+
+		if (prev_below && next_below)
+			types[i] = convex ? VERTEX_START : VERTEX_SPLIT;
+		else if (!prev_below && !next_below)
+			types[i] = convex ? VERTEX_END : VERTEX_MERGE;
+		else
+			types[i] = prev_below ? VERTEX_REGULAR_RIGHT : VERTEX_REGULAR_LEFT;
+	}
+
+	_MonotoneSweep sweep;
+	sweep.points = points;
+	sweep.count = n;
+
+	typedef Map<_MonotoneEdge, int> EdgeMap;
+	EdgeMap status;
+	Vector<EdgeMap::Element *> edge_elements;
+	Vector<int> helper;
+	Vector<int> diagonals;
+	edge_elements.resize(n);
+	helper.resize(n);
+	for (int i = 0; i < n; i++) {
+		edge_elements[i] = NULL;
+		helper[i] = -1;
+	}
+
+	_MonotoneEdge query;
+	query.sweep = &sweep;
+
+	for (int k = 0; k < n; k++) {
+
+		int i = order[k];
+		int prev = (i + n - 1) % n;
+		int type = types[i];
+		sweep.pos = points[i];
+
+		// the edge coming down into this vertex ends here
+		if (type == VERTEX_END || type == VERTEX_MERGE || type == VERTEX_REGULAR_LEFT) {
+
+			if (!edge_elements[prev])
+				return triangulate(contour, result);
+
+			if (types[helper[prev]] == VERTEX_MERGE) {
+				diagonals.push_back(i);
+				diagonals.push_back(helper[prev]);
+			}
+			status.erase(edge_elements[prev]);
+			edge_elements[prev] = NULL;
+		}
+
+		// the edge directly left of this vertex gets it as helper
+		if (type == VERTEX_SPLIT || type == VERTEX_MERGE || type == VERTEX_REGULAR_RIGHT) {
+
+			EdgeMap::Element *E = status.find_closest(query);
+			if (!E)
+				return triangulate(contour, result);
+
+			int left = E->get();
+			if (type == VERTEX_SPLIT || types[helper[left]] == VERTEX_MERGE) {
+				diagonals.push_back(i);
+				diagonals.push_back(helper[left]);
+			}
+			helper[left] = i;
+		}
+
+		// the edge going down from this vertex starts here
+		if (type == VERTEX_START || type == VERTEX_SPLIT || type == VERTEX_REGULAR_LEFT) {
+
+			_MonotoneEdge edge;
+			edge.sweep = &sweep;
+			edge.from = i;
+			edge_elements[i] = status.insert(edge, i);
+			helper[i] = i;
+		}
+	}
+
+	/* walk the faces formed by the contour and the diagonals, each one is a monotone piece */
+
+	Vector<int> pieces_triangles;
+
+	if (diagonals.empty()) {
+
+		Vector<int> piece;
+		piece.resize(n);
+		for (int i = 0; i < n; i++)
+			piece[i] = i;
+		if (!_triangulate_monotone_piece(points, piece, pieces_triangles))
+			return triangulate(contour, result);
+
+	} else {
+
+		// half edges, the first n follow the contour, then both directions of each diagonal
+		int diagonal_count = diagonals.size() / 2;
+		int half_edge_count = n + diagonal_count * 2;
+
+		Vector<int> edge_from;
+		Vector<int> edge_to;
+		edge_from.resize(half_edge_count);
+		edge_to.resize(half_edge_count);
+		for (int i = 0; i < n; i++) {
+			edge_from[i] = i;
+			edge_to[i] = (i + 1) % n;
+		}
+		for (int i = 0; i < diagonal_count; i++) {
+			edge_from[n + i * 2 + 0] = diagonals[i * 2 + 0];
+			edge_to[n + i * 2 + 0] = diagonals[i * 2 + 1];
+			edge_from[n + i * 2 + 1] = diagonals[i * 2 + 1];
+			edge_to[n + i * 2 + 1] = diagonals[i * 2 + 0];
+		}
+
+		// outgoing half edges of each vertex
+		Vector<int> outgoing_ofs;
+		Vector<int> outgoing;
+		outgoing_ofs.resize(n + 1);
+		outgoing.resize(half_edge_count);
+		for (int i = 0; i <= n; i++)
+			outgoing_ofs[i] = 0;
+		for (int i = 0; i < half_edge_count; i++)
+			outgoing_ofs[edge_from[i] + 1]++;
+		for (int i = 0; i < n; i++)
+			outgoing_ofs[i + 1] += outgoing_ofs[i];
+		{
+			Vector<int> fill = outgoing_ofs;
+			for (int i = 0; i < half_edge_count; i++)
+				outgoing[fill[edge_from[i]]++] = i;
+		}
+
+		Vector<bool> visited;
+		visited.resize(half_edge_count);
+		for (int i = 0; i < half_edge_count; i++)
+			visited[i] = false;
+
+		Vector<int> piece;
+
+		for (int h = 0; h < half_edge_count; h++) {
+
+			if (visited[h])
+				continue;
+
+			piece.clear();
+			int current = h;
+
+			do {
+
+				if (visited[current] || piece.size() >= n)
+					return triangulate(contour, result);
+
+				visited[current] = true;
+				piece.push_back(edge_from[current]);
+
+				// keep the piece on the left, taking the first edge clockwise
+				// from the one we arrived through
+				int v = edge_to[current];
+				Vector2 back = points[edge_from[current]] - points[v];
+				real_t back_angle = Math::atan2(back.y, back.x);
+
+				int next = -1;
+				real_t next_turn = 0;
+				for (int j = outgoing_ofs[v]; j < outgoing_ofs[v + 1]; j++) {
+
+					int candidate = outgoing[j];
+					if (edge_to[candidate] == edge_from[current])
+						continue; //back through the same diagonal
+
+					Vector2 dir = points[edge_to[candidate]] - points[v];
+					real_t turn = back_angle - Math::atan2(dir.y, dir.x);
+					if (turn <= 0)
+						turn += Math_PI * 2.0;
+
+					if (next == -1 || turn < next_turn) {
+						next = candidate;
+						next_turn = turn;
+					}
+				}
+
+				current = next;
+
+			} while (current != h);
+
+			if (!_triangulate_monotone_piece(points, piece, pieces_triangles))
+				return triangulate(contour, result);
+		}
+	}
+
+	/* a valid triangulation covers the contour exactly once */
+
+	if (pieces_triangles.size() != (n - 2) * 3)
+		return triangulate(contour, result);
+
+	real_t covered = 0;
+	for (int i = 0; i < pieces_triangles.size(); i += 3) {
+		const Vector2 &a = points[pieces_triangles[i + 0]];
+		const Vector2 &b = points[pieces_triangles[i + 1]];
+		const Vector2 &c = points[pieces_triangles[i + 2]];
+		covered += Math::abs((b - a).cross(c - a)) * 0.5;
+	}
+
+	if (Math::abs(covered - Math::abs(area)) > Math::abs(area) * 0.0001)
+		return triangulate(contour, result);
+
+	int from = result.size();
+	result.resize(from + pieces_triangles.size());
+	for (int i = 0; i < pieces_triangles.size(); i++)
+		result[from + i] = V[pieces_triangles[i]];
+
+	return true;
+}
@@ -43,6 +43,11 @@ public:
 	// as series of triangles.
 	static bool triangulate(const Vector<Vector2> &contour, Vector<int> &result);
 
+	// same, but splits the contour into y-monotone pieces with a sweep line
+	// first, which is O(n log n) instead of O(n^2). Degenerate contours
+	// (repeated points, self intersections) fall back to triangulate().
+	static bool triangulate_monotone(const Vector<Vector2> &contour, Vector<int> &result);
+
 	// compute area of a contour/polygon
 	static real_t get_area(const Vector<Vector2> &contour);
 
@@ -54,6 +59,7 @@ public:
 			real_t Px, real_t Py);
 
 private:
+	static bool _triangulate_monotone_piece(const Vector2 *p_points, const Vector<int> &p_piece, Vector<int> &r_triangles);
 	static bool snip(const Vector<Vector2> &p_contour, int u, int v, int w, int n, const Vector<int> &V);
 };
 
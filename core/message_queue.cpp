@@ -30,33 +30,125 @@
 
 #include "message_queue.h"
 
+#include "os/thread.h"
+#include "profiler.h"
 #include "project_settings.h"
+#include "safe_refcount.h"
 #include "script_language.h"
 
 MessageQueue *MessageQueue::singleton = NULL;
 
+static _FORCE_INLINE_ bool _is_main_thread() {
+
+	// before the main thread is known, nothing else can be running yet
+	return Thread::get_main_id() == 0 || Thread::get_caller_id() == Thread::get_main_id();
+}
+
 MessageQueue *MessageQueue::get_singleton() {
 
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
 
-	_THREAD_SAFE_METHOD_
+	switch (p_message->type & FLAG_MASK) {
+		case TYPE_NOTIFICATION: return sizeof(Message);
+		case TYPE_METHOD: return sizeof(Message) + sizeof(MethodCall);
+		default: return sizeof(Message) + sizeof(Variant) * p_message->args;
+	}
+}
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+MessageQueue::Block *MessageQueue::_alloc_block(uint32_t p_size) {
+
+	Block *block = (Block *)Memory::alloc_static(((sizeof(Block) + 15) & ~15) + p_size);
+	block->next = NULL;
+	block->size = p_size;
+	block->used = 0;
+	block->sealed = 0;
+	return block;
+}
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed method: " + type + ":" + p_method + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+MessageQueue::Staging *MessageQueue::_get_thread_staging() {
+
+	// Stagings are only ever prepended, fully set up and under the lock, and
+	// live as long as the queue, so the list can be walked without it.
+	Thread::ID id = Thread::get_caller_id();
+	for (Staging *staging = stagings; staging; staging = staging->next) {
+		if (staging->thread == id)
+			return staging;
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	// First message pushed from this thread, the only time a lock is taken.
+	Staging *staging = memnew(Staging);
+	staging->thread = id;
+	staging->write_block = _alloc_block(STAGING_BLOCK_SIZE);
+	staging->write_pos = 0;
+	staging->read_block = staging->write_block;
+	staging->read_pos = 0;
+
+	_THREAD_SAFE_LOCK_
+	staging->next = stagings;
+	stagings = staging;
+	_THREAD_SAFE_UNLOCK_
+
+	return staging;
+}
+
+uint8_t *MessageQueue::_reserve(uint32_t p_size, Staging *&r_staging) {
+
+	if (_is_main_thread()) {
+
+		r_staging = NULL;
+
+		Block *block = write_block;
+		while (block->used + p_size > block->size) {
+			// blocks past the write block are empty, kept from earlier frames
+			if (!block->next)
+				block->next = _alloc_block(MAX(block_size, p_size));
+			block = block->next;
+		}
+		write_block = block;
+
+		uint8_t *ptr = _get_block_data(block) + block->used;
+		block->used += p_size;
+		buffer_end += p_size;
+		return ptr;
+	}
+
+	Staging *staging = _get_thread_staging();
+	r_staging = staging;
+
+	Block *block = staging->write_block;
+	if (staging->write_pos + p_size > block->size) {
+		Block *next = _alloc_block(MAX((uint32_t)STAGING_BLOCK_SIZE, p_size));
+		block->next = next;
+		atomic_exchange_if_greater(&block->sealed, (uint32_t)1);
+		staging->write_block = next;
+		staging->write_pos = 0;
+		block = next;
+	}
+
+	uint8_t *ptr = _get_block_data(block) + staging->write_pos;
+	staging->write_pos += p_size;
+	return ptr;
+}
+
+void MessageQueue::_commit(Staging *p_staging, Message *p_message) {
+
+	// numbered only now, so flush() never waits on a lower number still being written
+	p_message->sequence = atomic_increment(&sequence);
+
+	// publishes the message just written to the flushing thread
+	if (p_staging)
+		atomic_exchange_if_greater(&p_staging->write_block->used, p_staging->write_pos);
+}
+
+Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	Staging *staging;
+	uint8_t *ptr = _reserve(sizeof(Message) + sizeof(Variant) * p_argcount, staging);
+
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = p_argcount;
 	msg->instance_ID = p_id;
 	msg->target = p_method;
@@ -64,15 +156,15 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 	if (p_show_error)
 		msg->type |= FLAG_SHOW_ERROR;
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
 
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_commit(staging, msg);
+
 	return OK;
 }
 
@@ -93,61 +185,59 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
 
-	_THREAD_SAFE_METHOD_
+	Staging *staging;
+	uint8_t *ptr = _reserve(sizeof(Message) + sizeof(Variant), staging);
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = 1;
 	msg->instance_ID = p_id;
 	msg->target = p_prop;
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(msg + 1, Variant);
 	*v = p_value;
 
+	_commit(staging, msg);
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	Staging *staging;
+	uint8_t *ptr = _reserve(sizeof(Message), staging);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_ID = p_id;
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit(staging, msg);
+
+	return OK;
+}
+
+Error MessageQueue::_push_method(ObjectID p_id, MethodThunk p_thunk, const void *p_method, int p_method_size) {
+
+	ERR_FAIL_COND_V(p_method_size > METHOD_POINTER_MAX_SIZE, ERR_INVALID_PARAMETER);
+
+	Staging *staging;
+	uint8_t *ptr = _reserve(sizeof(Message) + sizeof(MethodCall), staging);
+
+	Message *msg = memnew_placement(ptr, Message);
+	msg->args = 0;
+	msg->instance_ID = p_id;
+	msg->type = TYPE_METHOD;
+
+	MethodCall *call = (MethodCall *)(msg + 1);
+	call->thunk = p_thunk;
+	copymem(call->method, p_method, p_method_size);
+
+	_commit(staging, msg);
 
 	return OK;
 }
@@ -171,59 +261,66 @@ void MessageQueue::statistics() {
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<StringName, int> call_count;
+	int method_count = 0;
 	int null_count = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	for (Block *block = blocks; block; block = block->next) {
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+		uint32_t read_pos = 0;
+		while (read_pos < block->used) {
+			Message *message = (Message *)&_get_block_data(block)[read_pos];
 
-		if (target != NULL) {
+			Object *target = ObjectDB::get_instance(message->instance_ID);
 
-			switch (message->type & FLAG_MASK) {
+			if (target != NULL) {
 
-				case TYPE_CALL: {
+				switch (message->type & FLAG_MASK) {
 
-					if (!call_count.has(message->target))
-						call_count[message->target] = 0;
+					case TYPE_CALL: {
 
-					call_count[message->target]++;
+						if (!call_count.has(message->target))
+							call_count[message->target] = 0;
 
-				} break;
-				case TYPE_NOTIFICATION: {
+						call_count[message->target]++;
 
-					if (!notify_count.has(message->notification))
-						notify_count[message->notification] = 0;
+					} break;
+					case TYPE_NOTIFICATION: {
 
-					notify_count[message->notification]++;
+						if (!notify_count.has(message->notification))
+							notify_count[message->notification] = 0;
 
-				} break;
-				case TYPE_SET: {
+						notify_count[message->notification]++;
 
-					if (!set_count.has(message->target))
-						set_count[message->target] = 0;
+					} break;
+					case TYPE_SET: {
 
-					set_count[message->target]++;
+						if (!set_count.has(message->target))
+							set_count[message->target] = 0;
 
-				} break;
-			}
+						set_count[message->target]++;
 
-			//object was deleted
-			//WARN_PRINT("Object was deleted while awaiting a callback")
-			//should it print a warning?
-		} else {
+					} break;
+					case TYPE_METHOD: {
 
-			null_count++;
-		}
+						method_count++;
+					} break;
+				}
+
+				//object was deleted
+				//WARN_PRINT("Object was deleted while awaiting a callback")
+				//should it print a warning?
+			} else {
+
+				null_count++;
+			}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+			read_pos += _get_message_size(message);
+		}
 	}
 
 	print_line("TOTAL BYTES: " + itos(buffer_end));
 	print_line("NULL count: " + itos(null_count));
+	print_line("METHOD count: " + itos(method_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
 
@@ -264,75 +361,152 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 	}
 }
 
-void MessageQueue::flush() {
+void MessageQueue::_destroy_message(Message *p_message) {
 
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-		//statistics();
+	switch (p_message->type & FLAG_MASK) {
+		case TYPE_CALL:
+		case TYPE_SET: {
+
+			Variant *args = (Variant *)(p_message + 1);
+			for (int i = 0; i < p_message->args; i++) {
+				args[i].~Variant();
+			}
+		} break;
 	}
 
-	uint32_t read_pos = 0;
+	p_message->~Message();
+}
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+void MessageQueue::_process_message(Message *p_message) {
 
-	while (read_pos < buffer_end) {
+	Object *target = ObjectDB::get_instance(p_message->instance_ID);
 
-		//lock on each iteration, so a call can re-add itself to the message queue
+	if (target != NULL) {
 
-		Message *message = (Message *)&buffer[read_pos];
+		switch (p_message->type & FLAG_MASK) {
+			case TYPE_CALL: {
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			advance += sizeof(Variant) * message->args;
+				Variant *args = (Variant *)(p_message + 1);
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+				// messages don't expect a return value
+
+				_call_function(target, p_message->target, args, p_message->args, p_message->type & FLAG_SHOW_ERROR);
+
+			} break;
+			case TYPE_NOTIFICATION: {
+
+				// messages don't expect a return value
+				target->notification(p_message->notification);
+
+			} break;
+			case TYPE_SET: {
+
+				Variant *arg = (Variant *)(p_message + 1);
+				// messages don't expect a return value
+				target->set(p_message->target, *arg);
+
+			} break;
+			case TYPE_METHOD: {
+
+				MethodCall *call = (MethodCall *)(p_message + 1);
+				call->thunk(target, call->method);
+
+			} break;
+		}
+	}
+
+	_destroy_message(p_message);
+}
+
+MessageQueue::Message *MessageQueue::_peek_staging(Staging *p_staging) {
+
+	while (true) {
+
+		Block *block = p_staging->read_block;
+
+		if (p_staging->read_pos < atomic_add(&block->used, (uint32_t)0))
+			return (Message *)&_get_block_data(block)[p_staging->read_pos];
 
-		_THREAD_SAFE_UNLOCK_
+		if (!atomic_add(&block->sealed, (uint32_t)0))
+			return NULL; // the pushing thread may still write to this block
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+		if (p_staging->read_pos < atomic_add(&block->used, (uint32_t)0))
+			continue; // published right before the block was sealed
 
-		if (target != NULL) {
+		p_staging->read_block = block->next;
+		p_staging->read_pos = 0;
+		Memory::free_static(block);
+	}
+}
 
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
+void MessageQueue::flush() {
 
-					Variant *args = (Variant *)(message + 1);
+	PROFILE_SCOPE("MessageQueue::flush");
 
-					// messages don't expect a return value
+	ERR_EXPLAIN("The message queue can only be flushed from the main thread.");
+	ERR_FAIL_COND(!_is_main_thread());
 
-					_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
+	if (flushing)
+		return; // messages pushed meanwhile are picked up by the flush in progress
 
-					for (int i = 0; i < message->args; i++) {
-						args[i].~Variant();
-					}
+	flushing = true;
 
-				} break;
-				case TYPE_NOTIFICATION: {
+	if (buffer_end > buffer_max_used) {
+		buffer_max_used = buffer_end;
+		//statistics();
+	}
 
-					// messages don't expect a return value
-					target->notification(message->notification);
+	_THREAD_SAFE_LOCK_
+	Staging *staging_list = stagings;
+	_THREAD_SAFE_UNLOCK_
+
+	// Run the main thread's messages and the staged ones from other threads in
+	// push order, including the ones pushed while flushing.
+
+	Block *read_block = blocks;
+	uint32_t read_pos = 0;
+
+	while (true) {
+
+		while (read_pos >= read_block->used && read_block != write_block) {
+			read_block = read_block->next;
+			read_pos = 0;
+		}
 
-				} break;
-				case TYPE_SET: {
+		Message *message = NULL;
+		Staging *message_staging = NULL;
 
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->target, *arg);
+		if (read_pos < read_block->used)
+			message = (Message *)&_get_block_data(read_block)[read_pos];
 
-					arg->~Variant();
-				} break;
+		for (Staging *staging = staging_list; staging; staging = staging->next) {
+
+			Message *staged = _peek_staging(staging);
+			if (staged && (!message || (int32_t)(staged->sequence - message->sequence) < 0)) {
+				message = staged;
+				message_staging = staging;
 			}
 		}
 
-		message->~Message();
+		if (!message)
+			break;
+
+		//pre-advance so this function is reentrant
+		if (message_staging)
+			message_staging->read_pos += _get_message_size(message);
+		else
+			read_pos += _get_message_size(message);
 
-		_THREAD_SAFE_LOCK_
+		_process_message(message);
 	}
 
+	for (Block *block = blocks; block; block = block->next) {
+		block->used = 0;
+	}
+	write_block = blocks;
 	buffer_end = 0; // reset buffer
-	_THREAD_SAFE_UNLOCK_
+
+	flushing = false;
 }
 
 MessageQueue::MessageQueue() {
@@ -342,31 +516,53 @@ MessageQueue::MessageQueue() {
 
 	buffer_end = 0;
 	buffer_max_used = 0;
-	buffer_size = GLOBAL_DEF("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	flushing = false;
+	// size of each block in the chain, more are added when a block fills up
+	block_size = GLOBAL_DEF("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	block_size *= 1024;
+	blocks = _alloc_block(block_size);
+	write_block = blocks;
+
+	stagings = NULL;
+	sequence = 0;
 }
 
 MessageQueue::~MessageQueue() {
 
-	uint32_t read_pos = 0;
+	for (Staging *staging = stagings; staging;) {
 
-	while (read_pos < buffer_end) {
+		Block *block = staging->read_block;
+		uint32_t read_pos = staging->read_pos;
+		while (block) {
+			while (read_pos < block->used) {
+				Message *message = (Message *)&_get_block_data(block)[read_pos];
+				read_pos += _get_message_size(message);
+				_destroy_message(message);
+			}
+			Block *next = block->next;
+			Memory::free_static(block);
+			block = next;
+			read_pos = 0;
+		}
 
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++)
-				args[i].~Variant();
+		Staging *next = staging->next;
+		memdelete(staging);
+		staging = next;
+	}
+
+	for (Block *block = blocks; block;) {
+
+		uint32_t read_pos = 0;
+		while (read_pos < block->used) {
+			Message *message = (Message *)&_get_block_data(block)[read_pos];
+			read_pos += _get_message_size(message);
+			_destroy_message(message);
 		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+		Block *next = block->next;
+		Memory::free_static(block);
+		block = next;
 	}
 
 	singleton = NULL;
-	memdelete_arr(buffer);
 }
@@ -32,24 +32,31 @@
 #define MESSAGE_QUEUE_H
 
 #include "object.h"
-#include "os/mutex.h"
+#include "os/thread.h"
 #include "os/thread_safe.h"
 
+/**
+ * Deferred calls, notifications and sets, run by flush() on the main thread.
+ * Messages run in the order they were pushed, across threads too: each one
+ * is numbered when published, and flush() merges the per-thread staging
+ * chains with the main thread's queue by that number.
+ */
 class MessageQueue {
 
 	_THREAD_SAFE_CLASS_
 
 	enum {
 
-		DEFAULT_QUEUE_SIZE_KB = 1024
+		DEFAULT_QUEUE_SIZE_KB = 1024,
+		STAGING_BLOCK_SIZE = 16 * 1024,
+		METHOD_POINTER_MAX_SIZE = 4 * sizeof(void *)
 	};
 
-	Mutex *mutex;
-
 	enum {
 		TYPE_CALL,
 		TYPE_NOTIFICATION,
 		TYPE_SET,
+		TYPE_METHOD,
 		FLAG_SHOW_ERROR = 1 << 14,
 		FLAG_MASK = FLAG_SHOW_ERROR - 1
 
@@ -58,20 +65,77 @@ class MessageQueue {
 	struct Message {
 
 		ObjectID instance_ID;
-		StringName target;
 		int16_t type;
 		union {
 			int16_t notification;
 			int16_t args;
 		};
+		uint32_t sequence; // push order across all threads
+		StringName target; // left empty for TYPE_METHOD
+	};
+
+	typedef void (*MethodThunk)(Object *p_target, const void *p_method);
+
+	// Follows the Message of a TYPE_METHOD entry, an argument-free call through a member function pointer.
+	struct MethodCall {
+
+		MethodThunk thunk;
+		uint8_t method[METHOD_POINTER_MAX_SIZE];
+	};
+
+	template <class T>
+	static void _method_thunk(Object *p_target, const void *p_method) {
+
+		typedef void (T::*Method)();
+		(static_cast<T *>(p_target)->*(*reinterpret_cast<const Method *>(p_method)))();
+	}
+
+public:
+	// Messages are written into chained blocks, more are allocated when one fills up.
+	struct Block {
+
+		Block *next;
+		uint32_t size;
+		uint32_t used; // in staging blocks, bytes published to the flushing thread
+		uint32_t sealed; // staging block no longer written to, next is valid
 	};
 
-	uint8_t *buffer;
+	// Messages pushed from threads other than the main one are staged per thread and drained in place on flush.
+	struct Staging {
+
+		Staging *next;
+		Thread::ID thread;
+		Block *write_block; // owned by the pushing thread
+		uint32_t write_pos;
+		Block *read_block; // owned by the flushing thread
+		uint32_t read_pos;
+	};
+
+private:
+	Block *blocks;
+	Block *write_block;
 	uint32_t buffer_end;
 	uint32_t buffer_max_used;
-	uint32_t buffer_size;
+	uint32_t block_size;
+	bool flushing;
+
+	Staging *stagings;
+	uint32_t sequence;
+
+	static _FORCE_INLINE_ uint8_t *_get_block_data(Block *p_block) { return reinterpret_cast<uint8_t *>(p_block) + ((sizeof(Block) + 15) & ~15); }
+	static _FORCE_INLINE_ uint32_t _get_message_size(const Message *p_message);
+
+	static Block *_alloc_block(uint32_t p_size);
+	Staging *_get_thread_staging();
+	uint8_t *_reserve(uint32_t p_size, Staging *&r_staging);
+	void _commit(Staging *p_staging, Message *p_message);
 
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
+	void _process_message(Message *p_message);
+	void _destroy_message(Message *p_message);
+	Message *_peek_staging(Staging *p_staging);
+
+	Error _push_method(ObjectID p_id, MethodThunk p_thunk, const void *p_method, int p_method_size);
 
 	static MessageQueue *singleton;
 
@@ -87,6 +151,14 @@ public:
 	Error push_notification(Object *p_object, int p_notification);
 	Error push_set(Object *p_object, const StringName &p_prop, const Variant &p_value);
 
+	// Deferred call to a method without arguments, skips method lookup by name and Variant arguments.
+	template <class T, class M>
+	Error push_call(T *p_object, void (M::*p_method)()) {
+
+		M *target = p_object;
+		return _push_method(target->get_instance_id(), &_method_thunk<M>, &p_method, sizeof(p_method));
+	}
+
 	void statistics();
 	void flush();
 
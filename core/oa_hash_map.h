@@ -32,562 +32,434 @@
 #define OA_HASH_MAP_H
 
 #include "hashfuncs.h"
+#include "list.h"
 #include "math_funcs.h"
 #include "os/copymem.h"
 #include "os/memory.h"
 
-// uncomment this to disable initial local storage.
-#define OA_HASH_MAP_INITIAL_LOCAL_STORAGE
-
 /**
- * This class implements a hash map datastructure that uses open addressing with
- * local probing.
- *
- * It can give huge performance improvements over a chained HashMap because of
- * the increased data locality.
- *
- * Because of that locality property it's important to not use "large" value
- * types as the "TData" type. If TData values are too big it can cause more
- * cache misses then chaining. If larger values are needed then storing those
- * in a separate array and using pointers or indices to reference them is the
- * better solution.
+ * A hash map that uses open addressing with Robin Hood probing: keys, values
+ * and hashes live in three flat arrays and an entry that is further away from
+ * its ideal slot takes the place of one that is closer, which keeps probe
+ * sequences short even at high load. Removal shifts the following entries back
+ * instead of leaving tombstones.
  *
- * This hash map also implements real-time incremental rehashing.
+ * Besides its own API it mirrors the part of HashMap that is used around the
+ * engine (set/getptr/has/erase/next/operator[]), so it can replace HashMap
+ * where lookups are hot. Unlike HashMap, entries move on insertion and removal:
+ * pointers returned by getptr() and next() are only valid until the map is
+ * modified.
  *
+ * As values are stored inline, large value types should be kept out of it or
+ * referenced by pointer.
  */
-template <class TKey, class TData,
-		uint16_t INITIAL_NUM_ELEMENTS = 64,
+template <class TKey, class TValue,
 		class Hasher = HashMapHasherDefault,
 		class Comparator = HashMapComparatorDefault<TKey> >
 class OAHashMap {
 
-private:
-#ifdef OA_HASH_MAP_INITIAL_LOCAL_STORAGE
-	TData local_data[INITIAL_NUM_ELEMENTS];
-	TKey local_keys[INITIAL_NUM_ELEMENTS];
-	uint32_t local_hashes[INITIAL_NUM_ELEMENTS];
-	uint8_t local_flags[INITIAL_NUM_ELEMENTS / 4 + (INITIAL_NUM_ELEMENTS % 4 != 0 ? 1 : 0)];
-#endif
+	enum {
+		MIN_CAPACITY = 8,
+		EMPTY_HASH = 0,
+	};
 
-	struct {
-		TData *data;
-		TKey *keys;
-		uint32_t *hashes;
+	TValue *values;
+	TKey *keys;
+	uint32_t *hashes;
 
-		// This is actually an array of bits, 4 bit pairs per octet.
-		// | ba ba ba ba | ba ba ba ba | ....
-		//
-		// if a is set it means that there is an element present.
-		// if b is set it means that an element was deleted. This is needed for
-		//   the local probing to work without relocating any succeeding and
-		//    colliding entries.
-		uint8_t *flags;
+	uint32_t capacity; // zero or a power of two, storage is allocated on first insertion
+	uint32_t num_elements;
+	uint32_t initial_capacity;
 
-		uint32_t capacity;
-	} table, old_table;
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
 
-	bool is_rehashing;
-	uint32_t rehash_position;
-	uint32_t rehash_amount;
+		uint32_t hash = Hasher::hash(p_key);
+		if (hash == EMPTY_HASH)
+			hash = EMPTY_HASH + 1; // zero marks free slots
+		return hash;
+	}
 
-	uint32_t elements;
+	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) const {
 
-	/* Methods */
+		return (p_pos - (p_hash & (capacity - 1))) & (capacity - 1);
+	}
 
-	// returns true if the value already existed, false if it's a new entry
-	bool _raw_set_with_hash(uint32_t p_hash, const TKey &p_key, const TData &p_data) {
-		for (int i = 0; i < table.capacity; i++) {
+	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
 
-			int pos = (p_hash + i) % table.capacity;
+		if (num_elements == 0)
+			return false;
 
-			int flags_pos = pos / 4;
-			int flags_pos_offset = pos % 4;
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = hash & (capacity - 1);
+		uint32_t distance = 0;
 
-			bool is_filled_flag = table.flags[flags_pos] & (1 << (2 * flags_pos_offset));
-			bool is_deleted_flag = table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1));
+		while (true) {
 
-			if (is_filled_flag) {
-				if (table.hashes[pos] == p_hash && Comparator::compare(table.keys[pos], p_key)) {
-					table.data[pos] = p_data;
-					return true;
-				}
-				continue;
-			}
+			if (hashes[pos] == EMPTY_HASH)
+				return false;
 
-			table.keys[pos] = p_key;
-			table.data[pos] = p_data;
-			table.hashes[pos] = p_hash;
+			// an entry closer to home than we are means the key would have been placed before it
+			if (distance > _get_probe_length(pos, hashes[pos]))
+				return false;
 
-			table.flags[flags_pos] |= (1 << (2 * flags_pos_offset));
-			table.flags[flags_pos] &= ~(1 << (2 * flags_pos_offset + 1));
+			if (hashes[pos] == hash && Comparator::compare(keys[pos], p_key)) {
+				r_pos = pos;
+				return true;
+			}
 
-			return false;
+			pos = (pos + 1) & (capacity - 1);
+			distance++;
 		}
-		return false;
 	}
 
-public:
-	_FORCE_INLINE_ uint32_t get_capacity() const { return table.capacity; }
-	_FORCE_INLINE_ uint32_t get_num_elements() const { return elements; }
-
-	void set(const TKey &p_key, const TData &p_data) {
-
-		uint32_t hash = Hasher::hash(p_key);
-
-		// We don't progress the rehashing if the table just got resized
-		// to keep the cost of this function low.
-		if (is_rehashing) {
-
-			// rehash progress
-
-			for (int i = 0; i <= rehash_amount && rehash_position < old_table.capacity; rehash_position++) {
+	// Returns the slot the key ended up in.
+	uint32_t _insert_with_hash(uint32_t p_hash, const TKey &p_key, const TValue &p_value) {
 
-				int flags_pos = rehash_position / 4;
-				int flags_pos_offset = rehash_position % 4;
+		uint32_t hash = p_hash;
+		uint32_t distance = 0;
+		uint32_t pos = hash & (capacity - 1);
+		uint32_t inserted_pos = capacity;
 
-				bool is_filled_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
-				bool is_deleted_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1))) > 0;
+		TKey key = p_key;
+		TValue value = p_value;
 
-				if (is_filled_flag) {
-					_raw_set_with_hash(old_table.hashes[rehash_position], old_table.keys[rehash_position], old_table.data[rehash_position]);
+		while (true) {
 
-					old_table.keys[rehash_position].~TKey();
-					old_table.data[rehash_position].~TData();
+			if (hashes[pos] == EMPTY_HASH) {
 
-					memnew_placement(&old_table.keys[rehash_position], TKey);
-					memnew_placement(&old_table.data[rehash_position], TData);
+				memnew_placement(&keys[pos], TKey(key));
+				memnew_placement(&values[pos], TValue(value));
+				hashes[pos] = hash;
 
-					old_table.flags[flags_pos] &= ~(1 << (2 * flags_pos_offset));
-					old_table.flags[flags_pos] |= (1 << (2 * flags_pos_offset + 1));
-				}
+				num_elements++;
+				return inserted_pos == capacity ? pos : inserted_pos;
 			}
 
-			if (rehash_position >= old_table.capacity) {
+			// Robin Hood: take the slot from a richer entry and carry it on instead.
+			uint32_t existing_distance = _get_probe_length(pos, hashes[pos]);
+			if (existing_distance < distance) {
 
-				// wohooo, we can get rid of the old table.
-				is_rehashing = false;
+				if (inserted_pos == capacity)
+					inserted_pos = pos;
 
-#ifdef OA_HASH_MAP_INITIAL_LOCAL_STORAGE
-				if (old_table.data == local_data) {
-					// Everything is local, so no cleanup :P
-				} else
-#endif
-				{
-					memdelete_arr(old_table.data);
-					memdelete_arr(old_table.keys);
-					memdelete_arr(old_table.hashes);
-					memdelete_arr(old_table.flags);
-				}
+				SWAP(hash, hashes[pos]);
+				SWAP(key, keys[pos]);
+				SWAP(value, values[pos]);
+				distance = existing_distance;
 			}
-		}
-
-		// Table is almost full, resize and start rehashing process.
-		if (elements >= table.capacity * 0.7) {
-
-			old_table.capacity = table.capacity;
-			old_table.data = table.data;
-			old_table.flags = table.flags;
-			old_table.hashes = table.hashes;
-			old_table.keys = table.keys;
-
-			table.capacity = old_table.capacity * 2;
-
-			table.data = memnew_arr(TData, table.capacity);
-			table.flags = memnew_arr(uint8_t, table.capacity / 4 + (table.capacity % 4 != 0 ? 1 : 0));
-			table.hashes = memnew_arr(uint32_t, table.capacity);
-			table.keys = memnew_arr(TKey, table.capacity);
 
-			zeromem(table.flags, table.capacity / 4 + (table.capacity % 4 != 0 ? 1 : 0));
-
-			is_rehashing = true;
-			rehash_position = 0;
-			rehash_amount = (elements * 2) / (table.capacity * 0.7 - old_table.capacity);
+			pos = (pos + 1) & (capacity - 1);
+			distance++;
 		}
-
-		if (!_raw_set_with_hash(hash, p_key, p_data))
-			elements++;
 	}
 
-	/**
-	 * returns true if the value was found, false otherwise.
-	 *
-	 * if r_data is not NULL then the value will be written to the object
-	 * it points to.
-	 */
-	bool lookup(const TKey &p_key, TData *r_data) {
-
-		uint32_t hash = Hasher::hash(p_key);
-
-		bool check_old_table = is_rehashing;
-		bool check_new_table = true;
-
-		// search for the key and return the value associated with it
-		//
-		// if we're rehashing we need to check both the old and the
-		// current table. If we find a value in the old table we still
-		// need to continue searching in the new table as it might have
-		// been added after
-
-		TData *value = NULL;
+	void _resize_and_rehash(uint32_t p_new_capacity) {
 
-		for (int i = 0; i < table.capacity; i++) {
-
-			if (!check_new_table && !check_old_table) {
-
-				break;
-			}
+		uint32_t old_capacity = capacity;
+		TKey *old_keys = keys;
+		TValue *old_values = values;
+		uint32_t *old_hashes = hashes;
 
-			// if we're rehashing check the old table
-			if (check_old_table && i < old_table.capacity) {
+		capacity = p_new_capacity;
+		num_elements = 0;
 
-				int pos = (hash + i) % old_table.capacity;
+		keys = static_cast<TKey *>(Memory::alloc_static(sizeof(TKey) * capacity));
+		values = static_cast<TValue *>(Memory::alloc_static(sizeof(TValue) * capacity));
+		hashes = static_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
+		zeromem(hashes, sizeof(uint32_t) * capacity);
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+		for (uint32_t i = 0; i < old_capacity; i++) {
 
-				bool is_filled_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
-				bool is_deleted_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1))) > 0;
-
-				if (is_filled_flag) {
-					// found our entry?
-					if (old_table.hashes[pos] == hash && Comparator::compare(old_table.keys[pos], p_key)) {
-						value = &old_table.data[pos];
-						check_old_table = false;
-					}
-				} else if (!is_deleted_flag) {
-
-					// we hit an empty field here, we don't
-					// need to further check this old table
-					// because we know it's not in here.
+			if (old_hashes[i] == EMPTY_HASH)
+				continue;
 
-					check_old_table = false;
-				}
-			}
+			_insert_with_hash(old_hashes[i], old_keys[i], old_values[i]);
 
-			if (check_new_table) {
-
-				int pos = (hash + i) % table.capacity;
-
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
-
-				bool is_filled_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
-				bool is_deleted_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1))) > 0;
-
-				if (is_filled_flag) {
-					// found our entry?
-					if (table.hashes[pos] == hash && Comparator::compare(table.keys[pos], p_key)) {
-						if (r_data != NULL)
-							*r_data = table.data[pos];
-						return true;
-					}
-					continue;
-				} else if (is_deleted_flag) {
-					continue;
-				} else if (value != NULL) {
-
-					// We found a value in the old table
-					if (r_data != NULL)
-						*r_data = *value;
-					return true;
-				} else {
-					check_new_table = false;
-				}
-			}
+			old_keys[i].~TKey();
+			old_values[i].~TValue();
 		}
 
-		if (value != NULL) {
-			if (r_data != NULL)
-				*r_data = *value;
-			return true;
+		if (old_capacity) {
+			Memory::free_static(old_keys);
+			Memory::free_static(old_values);
+			Memory::free_static(old_hashes);
 		}
-		return false;
 	}
 
-	_FORCE_INLINE_ bool has(const TKey &p_key) {
-		return lookup(p_key, NULL);
-	}
+	_FORCE_INLINE_ void _reserve_one() {
 
-	void remove(const TKey &p_key) {
-		uint32_t hash = Hasher::hash(p_key);
+		if (capacity == 0) {
+			_resize_and_rehash(MAX((uint32_t)MIN_CAPACITY, next_power_of_2(initial_capacity)));
+		} else if ((num_elements + 1) * 8 > capacity * 7) { // keep the load factor under 7/8
+			_resize_and_rehash(capacity * 2);
+		}
+	}
 
-		bool check_old_table = is_rehashing;
-		bool check_new_table = true;
+	void _free_storage() {
 
-		for (int i = 0; i < table.capacity; i++) {
+		if (capacity == 0)
+			return;
 
-			if (!check_new_table && !check_old_table) {
-				return;
-			}
+		for (uint32_t i = 0; i < capacity; i++) {
 
-			// if we're rehashing check the old table
-			if (check_old_table && i < old_table.capacity) {
+			if (hashes[i] == EMPTY_HASH)
+				continue;
 
-				int pos = (hash + i) % old_table.capacity;
+			keys[i].~TKey();
+			values[i].~TValue();
+		}
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+		Memory::free_static(keys);
+		Memory::free_static(values);
+		Memory::free_static(hashes);
 
-				bool is_filled_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
-				bool is_deleted_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1))) > 0;
+		keys = NULL;
+		values = NULL;
+		hashes = NULL;
+		capacity = 0;
+		num_elements = 0;
+	}
 
-				if (is_filled_flag) {
-					// found our entry?
-					if (old_table.hashes[pos] == hash && Comparator::compare(old_table.keys[pos], p_key)) {
-						old_table.keys[pos].~TKey();
-						old_table.data[pos].~TData();
+	void _copy_from(const OAHashMap &p_from) {
 
-						memnew_placement(&old_table.keys[pos], TKey);
-						memnew_placement(&old_table.data[pos], TData);
+		initial_capacity = p_from.initial_capacity;
+		if (p_from.num_elements == 0)
+			return;
 
-						old_table.flags[flags_pos] &= ~(1 << (2 * flags_pos_offset));
-						old_table.flags[flags_pos] |= (1 << (2 * flags_pos_offset + 1));
+		_resize_and_rehash(p_from.capacity);
+		for (uint32_t i = 0; i < p_from.capacity; i++) {
 
-						elements--;
-						return;
-					}
-				} else if (!is_deleted_flag) {
+			if (p_from.hashes[i] != EMPTY_HASH)
+				_insert_with_hash(p_from.hashes[i], p_from.keys[i], p_from.values[i]);
+		}
+	}
 
-					// we hit an empty field here, we don't
-					// need to further check this old table
-					// because we know it's not in here.
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t get_num_elements() const { return num_elements; }
 
-					check_old_table = false;
-				}
-			}
+	_FORCE_INLINE_ unsigned int size() const { return num_elements; }
+	_FORCE_INLINE_ bool empty() const { return num_elements == 0; }
 
-			if (check_new_table) {
+	void clear() {
 
-				int pos = (hash + i) % table.capacity;
+		_free_storage();
+	}
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+	void insert(const TKey &p_key, const TValue &p_value) {
 
-				bool is_filled_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
-				bool is_deleted_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset + 1))) > 0;
+		_reserve_one();
+		_insert_with_hash(_hash(p_key), p_key, p_value);
+	}
 
-				if (is_filled_flag) {
-					// found our entry?
-					if (table.hashes[pos] == hash && Comparator::compare(table.keys[pos], p_key)) {
-						table.keys[pos].~TKey();
-						table.data[pos].~TData();
+	void set(const TKey &p_key, const TValue &p_data) {
 
-						memnew_placement(&table.keys[pos], TKey);
-						memnew_placement(&table.data[pos], TData);
+		uint32_t pos;
+		if (_lookup_pos(p_key, pos)) {
+			values[pos] = p_data;
+		} else {
+			insert(p_key, p_data);
+		}
+	}
 
-						table.flags[flags_pos] &= ~(1 << (2 * flags_pos_offset));
-						table.flags[flags_pos] |= (1 << (2 * flags_pos_offset + 1));
+	/**
+	 * returns true if the value was found, false otherwise.
+	 *
+	 * if r_data is not NULL then the value will be written to the object
+	 * it points to.
+	 */
+	bool lookup(const TKey &p_key, TValue *r_data) const {
 
-						// don't return here, this value might still be in the old table
-						// if it was already relocated.
+		uint32_t pos;
+		if (!_lookup_pos(p_key, pos))
+			return false;
 
-						elements--;
-						return;
-					}
-					continue;
-				} else if (is_deleted_flag) {
-					continue;
-				} else {
-					check_new_table = false;
-				}
-			}
-		}
+		if (r_data)
+			*r_data = values[pos];
+		return true;
 	}
 
-	struct Iterator {
-		bool valid;
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
 
-		uint32_t hash;
+		uint32_t pos;
+		return _lookup_pos(p_key, pos);
+	}
 
-		const TKey *key;
-		const TData *data;
+	_FORCE_INLINE_ TValue *getptr(const TKey &p_key) {
 
-	private:
-		friend class OAHashMap;
-		bool was_from_old_table;
-	};
+		uint32_t pos;
+		return _lookup_pos(p_key, pos) ? &values[pos] : NULL;
+	}
 
-	Iterator iter() const {
-		Iterator it;
+	_FORCE_INLINE_ const TValue *getptr(const TKey &p_key) const {
 
-		it.valid = false;
-		it.was_from_old_table = false;
+		uint32_t pos;
+		return _lookup_pos(p_key, pos) ? &values[pos] : NULL;
+	}
 
-		bool check_old_table = is_rehashing;
+	TValue &get(const TKey &p_key) {
 
-		for (int i = 0; i < table.capacity; i++) {
+		TValue *value = getptr(p_key);
+		CRASH_COND(!value);
+		return *value;
+	}
 
-			// if we're rehashing check the old table first
-			if (check_old_table && i < old_table.capacity) {
+	const TValue &get(const TKey &p_key) const {
 
-				int pos = i;
+		const TValue *value = getptr(p_key);
+		CRASH_COND(!value);
+		return *value;
+	}
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+	TValue &operator[](const TKey &p_key) {
 
-				bool is_filled_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
+		uint32_t pos;
+		if (!_lookup_pos(p_key, pos)) {
+			_reserve_one();
+			pos = _insert_with_hash(_hash(p_key), p_key, TValue());
+		}
+		return values[pos];
+	}
 
-				if (is_filled_flag) {
-					it.valid = true;
-					it.hash = old_table.hashes[pos];
-					it.data = &old_table.data[pos];
-					it.key = &old_table.keys[pos];
+	const TValue &operator[](const TKey &p_key) const {
 
-					it.was_from_old_table = true;
+		return get(p_key);
+	}
 
-					return it;
-				}
-			}
+	bool erase(const TKey &p_key) {
 
-			{
+		uint32_t pos;
+		if (!_lookup_pos(p_key, pos))
+			return false;
 
-				int pos = i;
+		keys[pos].~TKey();
+		values[pos].~TValue();
+		hashes[pos] = EMPTY_HASH;
+		num_elements--;
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+		// Backward shift: pull the following displaced entries one slot closer to home.
+		uint32_t next = (pos + 1) & (capacity - 1);
+		while (hashes[next] != EMPTY_HASH && _get_probe_length(next, hashes[next]) != 0) {
 
-				bool is_filled_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
+			memnew_placement(&keys[pos], TKey(keys[next]));
+			memnew_placement(&values[pos], TValue(values[next]));
+			hashes[pos] = hashes[next];
 
-				if (is_filled_flag) {
-					it.valid = true;
-					it.hash = table.hashes[pos];
-					it.data = &table.data[pos];
-					it.key = &table.keys[pos];
+			keys[next].~TKey();
+			values[next].~TValue();
+			hashes[next] = EMPTY_HASH;
 
-					return it;
-				}
-			}
+			pos = next;
+			next = (next + 1) & (capacity - 1);
 		}
 
-		return it;
+		return true;
 	}
 
-	Iterator next_iter(const Iterator &p_iter) const {
-		if (!p_iter.valid) {
-			return p_iter;
-		}
-
-		Iterator it;
-
-		it.valid = false;
-		it.was_from_old_table = false;
-
-		bool check_old_table = is_rehashing;
+	_FORCE_INLINE_ void remove(const TKey &p_key) {
 
-		// we use this to skip the first check or not
-		bool was_from_old_table = p_iter.was_from_old_table;
+		erase(p_key);
+	}
 
-		int prev_index = (p_iter.data - (p_iter.was_from_old_table ? old_table.data : table.data));
+	/**
+	 * HashMap style iteration: pass NULL to get the first key, then the
+	 * previous key to get the next one. The map must not change meanwhile.
+	 */
+	const TKey *next(const TKey *p_key) const {
 
-		if (!was_from_old_table) {
-			prev_index++;
+		uint32_t pos = 0;
+		if (p_key) {
+			ERR_FAIL_COND_V(p_key < keys || p_key >= keys + capacity, NULL);
+			pos = (p_key - keys) + 1;
 		}
 
-		for (int i = prev_index; i < table.capacity; i++) {
-
-			// if we're rehashing check the old table first
-			if (check_old_table && i < old_table.capacity && !was_from_old_table) {
-
-				int pos = i;
-
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+		for (; pos < capacity; pos++) {
+			if (hashes[pos] != EMPTY_HASH)
+				return &keys[pos];
+		}
+		return NULL;
+	}
 
-				bool is_filled_flag = (old_table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
+	void get_key_list(List<TKey> *p_keys) const {
 
-				if (is_filled_flag) {
-					it.valid = true;
-					it.hash = old_table.hashes[pos];
-					it.data = &old_table.data[pos];
-					it.key = &old_table.keys[pos];
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (hashes[i] != EMPTY_HASH)
+				p_keys->push_back(keys[i]);
+		}
+	}
 
-					it.was_from_old_table = true;
+	struct Iterator {
+		bool valid;
 
-					return it;
-				}
-			}
+		const TKey *key;
+		TValue *data;
 
-			was_from_old_table = false;
+	private:
+		uint32_t pos;
+		friend class OAHashMap;
+	};
 
-			{
-				int pos = i;
+	Iterator iter() const {
 
-				int flags_pos = pos / 4;
-				int flags_pos_offset = pos % 4;
+		Iterator it;
+		it.valid = false;
+		it.pos = 0;
+		return next_iter(it, true);
+	}
 
-				bool is_filled_flag = (table.flags[flags_pos] & (1 << (2 * flags_pos_offset))) > 0;
+	Iterator next_iter(const Iterator &p_iter, bool p_first = false) const {
 
-				if (is_filled_flag) {
-					it.valid = true;
-					it.hash = table.hashes[pos];
-					it.data = &table.data[pos];
-					it.key = &table.keys[pos];
+		Iterator it = p_iter;
+		if (!p_first) {
+			if (!p_iter.valid)
+				return p_iter;
+			it.pos++;
+		}
 
-					return it;
-				}
+		it.valid = false;
+		for (; it.pos < capacity; it.pos++) {
+			if (hashes[it.pos] != EMPTY_HASH) {
+				it.valid = true;
+				it.key = &keys[it.pos];
+				it.data = &values[it.pos];
+				break;
 			}
 		}
-
 		return it;
 	}
 
-	OAHashMap(uint32_t p_initial_capacity = INITIAL_NUM_ELEMENTS) {
-
-#ifdef OA_HASH_MAP_INITIAL_LOCAL_STORAGE
+	void operator=(const OAHashMap &p_from) {
 
-		if (p_initial_capacity <= INITIAL_NUM_ELEMENTS) {
-			table.data = local_data;
-			table.keys = local_keys;
-			table.hashes = local_hashes;
-			table.flags = local_flags;
+		if (&p_from == this)
+			return;
 
-			zeromem(table.flags, INITIAL_NUM_ELEMENTS / 4 + (INITIAL_NUM_ELEMENTS % 4 != 0 ? 1 : 0));
+		_free_storage();
+		_copy_from(p_from);
+	}
 
-			table.capacity = INITIAL_NUM_ELEMENTS;
-			elements = 0;
-		} else
-#endif
-		{
-			table.data = memnew_arr(TData, p_initial_capacity);
-			table.keys = memnew_arr(TKey, p_initial_capacity);
-			table.hashes = memnew_arr(uint32_t, p_initial_capacity);
-			table.flags = memnew_arr(uint8_t, p_initial_capacity / 4 + (p_initial_capacity % 4 != 0 ? 1 : 0));
+	OAHashMap(const OAHashMap &p_from) {
 
-			zeromem(table.flags, p_initial_capacity / 4 + (p_initial_capacity % 4 != 0 ? 1 : 0));
+		values = NULL;
+		keys = NULL;
+		hashes = NULL;
+		capacity = 0;
+		num_elements = 0;
+		_copy_from(p_from);
+	}
 
-			table.capacity = p_initial_capacity;
-			elements = 0;
-		}
+	OAHashMap(uint32_t p_initial_capacity = MIN_CAPACITY) {
 
-		is_rehashing = false;
-		rehash_position = 0;
+		values = NULL;
+		keys = NULL;
+		hashes = NULL;
+		capacity = 0;
+		num_elements = 0;
+		initial_capacity = p_initial_capacity;
 	}
 
 	~OAHashMap() {
-#ifdef OA_HASH_MAP_INITIAL_LOCAL_STORAGE
-		if (table.capacity <= INITIAL_NUM_ELEMENTS) {
-			return; // Everything is local, so no cleanup :P
-		}
-#endif
-		if (is_rehashing) {
-
-#ifdef OA_HASH_MAP_INITIAL_LOCAL_STORAGE
-			if (old_table.data == local_data) {
-				// Everything is local, so no cleanup :P
-			} else
-#endif
-			{
-				memdelete_arr(old_table.data);
-				memdelete_arr(old_table.keys);
-				memdelete_arr(old_table.hashes);
-				memdelete_arr(old_table.flags);
-			}
-		}
 
-		memdelete_arr(table.data);
-		memdelete_arr(table.keys);
-		memdelete_arr(table.hashes);
-		memdelete_arr(table.flags);
+		_free_storage();
 	}
 };
 
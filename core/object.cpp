@@ -1435,6 +1435,12 @@ bool Object::is_connected(const StringName &p_signal, Object *p_to_object, const
 	//return (E!=NULL);
 }
 
+bool Object::has_signal_connections(const StringName &p_signal) const {
+
+	const Signal *s = signal_map.getptr(p_signal);
+	return s && !s->slot_map.empty();
+}
+
 void Object::disconnect(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method) {
 
 	ERR_FAIL_NULL(p_to_object);
@@ -1829,9 +1835,9 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
+OAHashMap<ObjectID, Object *> ObjectDB::instances;
 ObjectID ObjectDB::instance_counter = 1;
-HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+OAHashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
 ObjectID ObjectDB::add_instance(Object *p_object) {
 
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
@@ -1859,13 +1865,14 @@ void ObjectDB::remove_instance(Object *p_object) {
 }
 Object *ObjectDB::get_instance(ObjectID p_instance_ID) {
 
+	// copied out under the lock, another thread adding or removing an
+	// instance may move the entries of the open addressed map
+	Object *obj = NULL;
 	rw_lock->read_lock();
-	Object **obj = instances.getptr(p_instance_ID);
+	instances.lookup(p_instance_ID, &obj);
 	rw_lock->read_unlock();
 
-	if (!obj)
-		return NULL;
-	return *obj;
+	return obj;
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
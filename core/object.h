@@ -33,6 +33,7 @@
 
 #include "list.h"
 #include "map.h"
+#include "oa_hash_map.h"
 #include "os/rw_lock.h"
 #include "set.h"
 #include "variant.h"
@@ -451,7 +452,7 @@ private:
 		Signal() { lock = 0; }
 	};
 
-	HashMap<StringName, Signal, StringNameHasher> signal_map;
+	OAHashMap<StringName, Signal, StringNameHasher> signal_map;
 	List<Connection> connections;
 #ifdef DEBUG_ENABLED
 	SafeRefCount _lock_index;
@@ -669,6 +670,7 @@ public:
 	Error connect(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method, const Vector<Variant> &p_binds = Vector<Variant>(), uint32_t p_flags = 0);
 	void disconnect(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method);
 	bool is_connected(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method) const;
+	bool has_signal_connections(const StringName &p_signal) const;
 
 	void call_deferred(const StringName &p_method, VARIANT_ARG_LIST);
 
@@ -712,8 +714,8 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<ObjectID, Object *> instances;
-	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
+	static OAHashMap<ObjectID, Object *> instances;
+	static OAHashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
 
 	static ObjectID instance_counter;
 	friend class Object;
@@ -106,6 +106,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_mapped_region() const { return NULL; } ///< whole file contents if they can be read in place (memory mapped), valid until close(); NULL otherwise
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(String delim = ",") const;
@@ -90,6 +90,11 @@ bool InputEvent::is_action_type() const {
 	return false;
 }
 
+bool InputEvent::accumulate(const Ref<InputEvent> &p_event) {
+
+	return false;
+}
+
 void InputEvent::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_device", "device"), &InputEvent::set_device);
@@ -109,6 +114,7 @@ void InputEvent::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_action_type"), &InputEvent::is_action_type);
 
 	ClassDB::bind_method(D_METHOD("xformed_by", "xform", "local_ofs"), &InputEvent::xformed_by, DEFVAL(Vector2()));
+	ClassDB::bind_method(D_METHOD("accumulate", "with_event"), &InputEvent::accumulate);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "device"), "set_device", "get_device");
 }
@@ -535,6 +541,26 @@ Vector2 InputEventMouseMotion::get_speed() const {
 	return speed;
 }
 
+void InputEventMouseMotion::set_position_history(const PoolVector2Array &p_history) {
+
+	position_history.resize(p_history.size());
+	PoolVector2Array::Read r = p_history.read();
+	for (int i = 0; i < p_history.size(); i++) {
+		position_history[i] = r[i];
+	}
+}
+
+PoolVector2Array InputEventMouseMotion::get_position_history() const {
+
+	PoolVector2Array history;
+	history.resize(position_history.size());
+	PoolVector2Array::Write w = history.write();
+	for (int i = 0; i < position_history.size(); i++) {
+		w[i] = position_history[i];
+	}
+	return history;
+}
+
 Ref<InputEvent> InputEventMouseMotion::xformed_by(const Transform2D &p_xform, const Vector2 &p_local_ofs) const {
 
 	Vector2 g = p_xform.xform(get_global_position());
@@ -556,6 +582,13 @@ Ref<InputEvent> InputEventMouseMotion::xformed_by(const Transform2D &p_xform, co
 	mm->set_relative(r);
 	mm->set_speed(s);
 
+	if (position_history.size()) {
+		mm->position_history.resize(position_history.size());
+		for (int i = 0; i < position_history.size(); i++) {
+			mm->position_history[i] = p_xform.xform(position_history[i] + p_local_ofs);
+		}
+	}
+
 	return mm;
 }
 
@@ -579,6 +612,38 @@ String InputEventMouseMotion::as_text() const {
 	return "InputEventMouseMotion : button_mask=" + button_mask_string + ", position=(" + String(get_position()) + "), relative=(" + String(get_relative()) + "), speed=(" + String(get_speed()) + ")";
 }
 
+bool InputEventMouseMotion::accumulate(const Ref<InputEvent> &p_event) {
+
+	Ref<InputEventMouseMotion> motion = p_event;
+	if (motion.is_null())
+		return false;
+
+	// Only motion that nobody could tell apart from the previous one may
+	// be folded into it: same device, same buttons held, same modifiers.
+	if (get_device() != motion->get_device() || get_button_mask() != motion->get_button_mask())
+		return false;
+
+	if (get_shift() != motion->get_shift() || get_alt() != motion->get_alt() || get_control() != motion->get_control() || get_metakey() != motion->get_metakey())
+		return false;
+
+	set_position(motion->get_position());
+	set_global_position(motion->get_global_position());
+	set_speed(motion->get_speed());
+	relative += motion->get_relative();
+
+	if (position_history.size()) {
+		if (motion->position_history.size()) {
+			for (int i = 0; i < motion->position_history.size(); i++) {
+				position_history.push_back(motion->position_history[i]);
+			}
+		} else {
+			position_history.push_back(motion->get_position());
+		}
+	}
+
+	return true;
+}
+
 void InputEventMouseMotion::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_relative", "relative"), &InputEventMouseMotion::set_relative);
@@ -587,8 +652,12 @@ void InputEventMouseMotion::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_speed", "speed"), &InputEventMouseMotion::set_speed);
 	ClassDB::bind_method(D_METHOD("get_speed"), &InputEventMouseMotion::get_speed);
 
+	ClassDB::bind_method(D_METHOD("set_position_history", "history"), &InputEventMouseMotion::set_position_history);
+	ClassDB::bind_method(D_METHOD("get_position_history"), &InputEventMouseMotion::get_position_history);
+
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "relative"), "set_relative", "get_relative");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "speed"), "set_speed", "get_speed");
+	ADD_PROPERTY(PropertyInfo(Variant::POOL_VECTOR2_ARRAY, "position_history"), "set_position_history", "get_position_history");
 }
 
 InputEventMouseMotion::InputEventMouseMotion() {
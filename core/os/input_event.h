@@ -167,6 +167,8 @@ public:
 	virtual bool shortcut_match(const Ref<InputEvent> &p_event) const;
 	virtual bool is_action_type() const;
 
+	virtual bool accumulate(const Ref<InputEvent> &p_event);
+
 	InputEvent();
 };
 
@@ -318,6 +320,7 @@ class InputEventMouseMotion : public InputEventMouse {
 	GDCLASS(InputEventMouseMotion, InputEventMouse)
 	Vector2 relative;
 	Vector2 speed;
+	Vector<Vector2> position_history; ///< every position merged into this event, only kept when requested
 
 protected:
 	static void _bind_methods();
@@ -329,9 +332,14 @@ public:
 	void set_speed(const Vector2 &p_speed);
 	Vector2 get_speed() const;
 
+	void set_position_history(const PoolVector2Array &p_history);
+	PoolVector2Array get_position_history() const;
+
 	virtual Ref<InputEvent> xformed_by(const Transform2D &p_xform, const Vector2 &p_local_ofs = Vector2()) const;
 	virtual String as_text() const;
 
+	virtual bool accumulate(const Ref<InputEvent> &p_event);
+
 	InputEventMouseMotion();
 };
 
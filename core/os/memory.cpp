@@ -68,6 +68,7 @@ void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_d
 #ifdef DEBUG_ENABLED
 uint64_t Memory::mem_usage = 0;
 uint64_t Memory::max_usage = 0;
+uint64_t Memory::alloc_total = 0;
 #endif
 
 uint64_t Memory::alloc_count = 0;
@@ -95,6 +96,7 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
 		atomic_add(&mem_usage, p_bytes);
 		atomic_exchange_if_greater(&max_usage, mem_usage);
+		atomic_increment(&alloc_total);
 #endif
 		return s8 + PAD_ALIGN;
 	} else {
@@ -204,6 +206,14 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_alloc_total() {
+#ifdef DEBUG_ENABLED
+	return alloc_total;
+#else
+	return 0;
+#endif
+}
+
 _GlobalNil::_GlobalNil() {
 
 	color = 1;
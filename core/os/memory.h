@@ -48,6 +48,7 @@ class Memory {
 #ifdef DEBUG_ENABLED
 	static uint64_t mem_usage;
 	static uint64_t max_usage;
+	static uint64_t alloc_total;
 #endif
 
 	static uint64_t alloc_count;
@@ -60,6 +61,7 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+	static uint64_t get_alloc_total(); ///< allocations made since startup, only counted in debug builds
 };
 
 class DefaultAllocator {
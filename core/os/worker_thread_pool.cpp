@@ -0,0 +1,392 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "error_macros.h"
+#include "os/os.h"
+#include "safe_refcount.h"
+
+#define QUEUE_INITIAL_CAPACITY 64
+#define WAIT_SPIN_COUNT 64
+
+struct WorkerThreadPool::Group {
+	uint32_t pending; // jobs left, plus one while the group is open
+	uint32_t refs; // the owner's handle and the completion
+	uint32_t done;
+	JobFunc continuation;
+	void *userdata;
+};
+
+WorkerThreadPool *WorkerThreadPool::singleton = NULL;
+
+WorkerThreadPool *WorkerThreadPool::get_singleton() {
+
+	return singleton;
+}
+
+int WorkerThreadPool::_get_queue_index() const {
+
+	Thread::ID caller = Thread::get_caller_id();
+	for (int i = 0; i < thread_count; i++) {
+		if (thread_ids[i] == caller)
+			return i;
+	}
+
+	return thread_count; // the shared queue
+}
+
+void WorkerThreadPool::_push(int p_queue, const Job &p_job) {
+
+	Queue &q = queues[p_queue];
+
+	q.lock->lock();
+
+	if (q.bottom - q.top == q.capacity) {
+
+		Job *jobs = memnew_arr(Job, q.capacity * 2);
+		for (uint32_t i = q.top; i != q.bottom; i++) {
+			jobs[i & (q.capacity * 2 - 1)] = q.jobs[i & (q.capacity - 1)];
+		}
+		memdelete_arr(q.jobs);
+		q.jobs = jobs;
+		q.capacity *= 2;
+	}
+
+	q.jobs[q.bottom & (q.capacity - 1)] = p_job;
+	q.bottom++;
+
+	q.lock->unlock();
+
+	work_semaphore->post();
+}
+
+bool WorkerThreadPool::_pop(int p_queue, Job &r_job) {
+
+	Queue &q = queues[p_queue];
+
+	q.lock->lock();
+
+	bool found = q.bottom != q.top;
+	if (found) {
+		q.bottom--;
+		r_job = q.jobs[q.bottom & (q.capacity - 1)];
+	}
+
+	q.lock->unlock();
+
+	return found;
+}
+
+bool WorkerThreadPool::_steal(int p_queue, Job &r_job) {
+
+	for (int i = 1; i < queue_count; i++) {
+
+		Queue &q = queues[(p_queue + i) % queue_count];
+
+		if (q.bottom == q.top)
+			continue; // racy peek, only to skip taking the lock of empty queues
+
+		q.lock->lock();
+
+		bool found = q.bottom != q.top;
+		if (found) {
+			r_job = q.jobs[q.top & (q.capacity - 1)];
+			q.top++;
+		}
+
+		q.lock->unlock();
+
+		if (found)
+			return true;
+	}
+
+	return false;
+}
+
+bool WorkerThreadPool::_run_one(int p_queue) {
+
+	Job job;
+	if (!_pop(p_queue, job) && !_steal(p_queue, job))
+		return false;
+
+	_run_job(job);
+	return true;
+}
+
+void WorkerThreadPool::_run_job(const Job &p_job) {
+
+	p_job.func(p_job.userdata);
+	_finish_job(p_job.group);
+}
+
+void WorkerThreadPool::_finish_job(Group *p_group) {
+
+	if (atomic_decrement(&p_group->pending) > 0)
+		return;
+
+	if (p_group->continuation) {
+		p_group->continuation(p_group->userdata);
+	}
+
+	atomic_increment(&p_group->done);
+	_release_group(p_group);
+}
+
+void WorkerThreadPool::_release_group(Group *p_group) {
+
+	if (atomic_decrement(&p_group->refs) == 0) {
+		memdelete(p_group);
+	}
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+
+	WorkerThreadPool *pool = singleton;
+	int index = (intptr_t)p_user;
+
+	pool->thread_ids[index] = Thread::get_caller_id();
+
+	while (true) {
+
+		pool->work_semaphore->wait();
+
+		if (pool->exit_threads)
+			break;
+
+		// the post that woke us may belong to a job someone else already
+		// took, so just drain whatever can be found
+		while (pool->_run_one(index)) {
+		}
+	}
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::begin_group(JobFunc p_continuation, void *p_userdata) {
+
+	Group *group = memnew(Group);
+	group->pending = 1;
+	group->refs = 2;
+	group->done = 0;
+	group->continuation = p_continuation;
+	group->userdata = p_userdata;
+
+	return group;
+}
+
+void WorkerThreadPool::add_job(Group *p_group, JobFunc p_func, void *p_userdata) {
+
+	ERR_FAIL_COND(!p_group);
+
+	if (thread_count == 0) {
+		p_func(p_userdata);
+		return;
+	}
+
+	atomic_increment(&p_group->pending);
+
+	Job job;
+	job.func = p_func;
+	job.userdata = p_userdata;
+	job.group = p_group;
+
+	_push(_get_queue_index(), job);
+}
+
+void WorkerThreadPool::end_group(Group *p_group) {
+
+	ERR_FAIL_COND(!p_group);
+
+	_finish_job(p_group);
+	_release_group(p_group);
+}
+
+void WorkerThreadPool::wait_group(Group *p_group) {
+
+	ERR_FAIL_COND(!p_group);
+
+	_finish_job(p_group);
+
+	int queue = thread_count > 0 ? _get_queue_index() : 0;
+	int idle = 0;
+
+	while (atomic_add(&p_group->done, 0) == 0) {
+
+		if (thread_count > 0 && _run_one(queue)) {
+			idle = 0;
+		} else if (++idle > WAIT_SPIN_COUNT) {
+			// what's left is running on other threads
+			OS::get_singleton()->delay_usec(1);
+		}
+	}
+
+	_release_group(p_group);
+}
+
+void WorkerThreadPool::_range_job(void *p_userdata) {
+
+	RangeData &data = *(RangeData *)p_userdata;
+
+	while (true) {
+		uint32_t chunk = atomic_increment(&data.next_chunk) - 1;
+		if (chunk >= data.chunks)
+			break;
+
+		uint32_t from = chunk * data.grain;
+		uint32_t to = MIN(from + data.grain, data.count);
+		data.func(data.userdata, from, to);
+	}
+}
+
+void WorkerThreadPool::parallel_for(uint32_t p_count, uint32_t p_grain, RangeFunc p_func, void *p_userdata) {
+
+	if (p_count == 0)
+		return;
+
+	if (p_grain == 0)
+		p_grain = 1;
+
+	uint32_t chunks = (p_count + p_grain - 1) / p_grain;
+
+	if (thread_count == 0 || chunks == 1) {
+		p_func(p_userdata, 0, p_count);
+		return;
+	}
+
+	RangeData data;
+	data.func = p_func;
+	data.userdata = p_userdata;
+	data.count = p_count;
+	data.grain = p_grain;
+	data.chunks = chunks;
+	data.next_chunk = 0;
+
+	// one job per helper is enough, they all pull chunks off the same counter
+	uint32_t helpers = MIN(chunks - 1, (uint32_t)thread_count);
+
+	Group *group = begin_group();
+	for (uint32_t i = 0; i < helpers; i++) {
+		add_job(group, _range_job, &data);
+	}
+
+	_range_job(&data);
+
+	wait_group(group);
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(threads != NULL);
+
+#ifndef NO_THREADS
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count() - 1;
+	}
+
+	if (p_thread_count <= 0)
+		return;
+
+	work_semaphore = Semaphore::create();
+	if (!work_semaphore)
+		return; // no threading support on this platform, run on the caller
+
+	queue_count = p_thread_count + 1;
+	queues = memnew_arr(Queue, queue_count);
+	for (int i = 0; i < queue_count; i++) {
+		queues[i].lock = Mutex::create();
+		queues[i].capacity = QUEUE_INITIAL_CAPACITY;
+		queues[i].jobs = memnew_arr(Job, QUEUE_INITIAL_CAPACITY);
+		queues[i].top = 0;
+		queues[i].bottom = 0;
+	}
+
+	exit_threads = false;
+
+	thread_ids = memnew_arr(Thread::ID, p_thread_count);
+	threads = memnew_arr(Thread *, p_thread_count);
+	for (int i = 0; i < p_thread_count; i++) {
+		thread_ids[i] = 0;
+		threads[i] = Thread::create(_thread_function, (void *)(intptr_t)i);
+	}
+
+	thread_count = p_thread_count;
+#endif
+}
+
+void WorkerThreadPool::finish() {
+
+	if (!threads)
+		return;
+
+	exit_threads = true;
+	for (int i = 0; i < thread_count; i++) {
+		work_semaphore->post();
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	for (int i = 0; i < queue_count; i++) {
+		memdelete(queues[i].lock);
+		memdelete_arr(queues[i].jobs);
+	}
+
+	memdelete_arr(queues);
+	memdelete_arr(threads);
+	memdelete_arr(thread_ids);
+	memdelete(work_semaphore);
+
+	queues = NULL;
+	threads = NULL;
+	thread_ids = NULL;
+	work_semaphore = NULL;
+	queue_count = 0;
+	thread_count = 0;
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+
+	singleton = this;
+
+	threads = NULL;
+	thread_ids = NULL;
+	thread_count = 0;
+	queues = NULL;
+	queue_count = 0;
+	work_semaphore = NULL;
+	exit_threads = false;
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+
+	finish();
+	singleton = NULL;
+}
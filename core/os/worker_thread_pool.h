@@ -0,0 +1,128 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "typedefs.h"
+
+/**
+	Process-wide pool of worker threads, created once and shared by every
+	subsystem that wants to run work in parallel.
+
+	Each worker owns a deque: it pushes and pops its own jobs at the bottom,
+	and when it runs dry steals from the top of the other deques. Jobs added
+	from threads outside the pool go to a shared deque every worker steals
+	from. Threads waiting on a group help running jobs instead of sleeping.
+*/
+class WorkerThreadPool {
+public:
+	typedef void (*JobFunc)(void *p_userdata);
+	typedef void (*RangeFunc)(void *p_userdata, uint32_t p_from, uint32_t p_to);
+
+	struct Group;
+
+private:
+	struct Job {
+		JobFunc func;
+		void *userdata;
+		Group *group;
+	};
+
+	struct Queue {
+		Mutex *lock;
+		Job *jobs;
+		uint32_t capacity; // power of two
+		uint32_t top; // stolen from here
+		uint32_t bottom; // pushed and popped by the owner here
+	};
+
+	struct RangeData {
+		RangeFunc func;
+		void *userdata;
+		uint32_t count;
+		uint32_t grain;
+		uint32_t chunks;
+		uint32_t next_chunk;
+	};
+
+	static WorkerThreadPool *singleton;
+
+	Thread **threads;
+	Thread::ID *thread_ids;
+	int thread_count;
+
+	Queue *queues; // one per worker, the last one is shared by outside threads
+	int queue_count;
+
+	Semaphore *work_semaphore;
+	volatile bool exit_threads;
+
+	static void _thread_function(void *p_user);
+	static void _range_job(void *p_userdata);
+
+	int _get_queue_index() const;
+	void _push(int p_queue, const Job &p_job);
+	bool _pop(int p_queue, Job &r_job);
+	bool _steal(int p_queue, Job &r_job);
+	bool _run_one(int p_queue);
+	void _run_job(const Job &p_job);
+	void _finish_job(Group *p_group);
+	void _release_group(Group *p_group);
+
+public:
+	// Groups start open, so jobs can keep being added until end_group() or
+	// wait_group() is called. The continuation (if any) runs on whichever
+	// thread completes the last job.
+	Group *begin_group(JobFunc p_continuation = NULL, void *p_userdata = NULL);
+	void add_job(Group *p_group, JobFunc p_func, void *p_userdata);
+	void end_group(Group *p_group); // don't wait, the group frees itself once done
+	void wait_group(Group *p_group); // runs pending jobs until the group is done, then frees it
+
+	// Calls p_func over [0, p_count) in chunks of at most p_grain elements,
+	// using the calling thread as well. Returns once every chunk ran.
+	void parallel_for(uint32_t p_count, uint32_t p_grain, RangeFunc p_func, void *p_userdata);
+
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
+
+	// p_thread_count < 0 uses one worker per extra core, 0 runs everything on the caller.
+	void init(int p_thread_count = -1);
+	void finish();
+
+	static WorkerThreadPool *get_singleton();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
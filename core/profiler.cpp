@@ -0,0 +1,223 @@
+/*************************************************************************/
+/*  profiler.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "profiler.h"
+
+#include "os/file_access.h"
+#include "os/os.h"
+#include "safe_refcount.h"
+
+uint32_t Profiler::capture_generation = 0;
+int Profiler::frames_left = 0;
+uint64_t Profiler::capture_begin = 0;
+Profiler::ThreadBuffer *Profiler::buffers = NULL;
+Mutex *Profiler::buffers_mutex = NULL;
+
+Profiler::ThreadBuffer *Profiler::_get_thread_buffer() {
+
+	// Buffers are only ever prepended, fully set up and under the lock, and
+	// live until finalize(), so the list can be walked without it. There is
+	// one per thread that ever recorded, few enough for a linear search.
+	Thread::ID id = Thread::get_caller_id();
+	for (ThreadBuffer *tb = buffers; tb; tb = tb->next) {
+		if (tb->thread == id)
+			return tb;
+	}
+
+	// First scope recorded by this thread, the only time a lock is taken.
+	ThreadBuffer *tb = memnew(ThreadBuffer);
+	tb->thread = id;
+	tb->generation = 0;
+	tb->write_pos = 0;
+	tb->writing = 0;
+
+	if (buffers_mutex)
+		buffers_mutex->lock();
+	tb->next = buffers;
+	buffers = tb;
+	if (buffers_mutex)
+		buffers_mutex->unlock();
+
+	return tb;
+}
+
+uint64_t Profiler::get_ticks_usec() {
+
+	return OS::get_singleton()->get_ticks_usec();
+}
+
+void Profiler::record(const char *p_name, uint64_t p_begin, uint64_t p_end) {
+
+	ThreadBuffer *tb = _get_thread_buffer();
+
+	// Flag the write before looking at the state. Both are full barriers, so
+	// either stop_capture() waits for this write or this sees it stopped.
+	atomic_increment(&tb->writing);
+
+	uint32_t generation = static_cast<uint32_t const volatile &>(capture_generation);
+	if (generation & 1) {
+
+		if (tb->generation != generation) {
+			// first event of a new capture, drop those of the last one
+			tb->generation = generation;
+			tb->write_pos = 0;
+		}
+
+		Event &e = tb->events[tb->write_pos & (THREAD_BUFFER_SIZE - 1)];
+		e.name = p_name;
+		e.begin = p_begin;
+		e.end = p_end;
+
+		// Publishes the event, older ones are overwritten once the ring is full.
+		atomic_increment(&tb->write_pos);
+	}
+
+	atomic_decrement(&tb->writing);
+}
+
+void Profiler::start_capture(int p_frames) {
+
+	if (buffers_mutex)
+		buffers_mutex->lock();
+
+	if (capture_generation & 1) {
+		atomic_increment(&capture_generation); // restart, end the running one first
+	}
+
+	frames_left = p_frames;
+	capture_begin = get_ticks_usec();
+	atomic_increment(&capture_generation);
+
+	if (buffers_mutex)
+		buffers_mutex->unlock();
+}
+
+void Profiler::stop_capture() {
+
+	if (buffers_mutex)
+		buffers_mutex->lock();
+
+	frames_left = 0;
+
+	if (capture_generation & 1) {
+
+		atomic_increment(&capture_generation);
+
+		// nothing records from here on, wait for what was already writing
+		for (ThreadBuffer *tb = buffers; tb; tb = tb->next) {
+			while (static_cast<uint32_t const volatile &>(tb->writing)) {
+			}
+		}
+	}
+
+	if (buffers_mutex)
+		buffers_mutex->unlock();
+}
+
+void Profiler::frame_mark() {
+
+	if (!is_capturing() || frames_left <= 0)
+		return;
+
+	frames_left--;
+	if (frames_left == 0)
+		stop_capture();
+}
+
+Error Profiler::save_chrome_trace(const String &p_path) {
+
+	ERR_FAIL_COND_V(is_capturing(), ERR_BUSY);
+
+	Error err;
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V(!f, err);
+
+	f->store_string("{\"traceEvents\":[\n");
+
+	if (buffers_mutex)
+		buffers_mutex->lock();
+
+	// stop_capture() made the generation even, the last capture is the one before
+	uint32_t generation = capture_generation - 1;
+
+	bool first = true;
+	int thread_index = 0;
+	for (ThreadBuffer *tb = buffers; tb; tb = tb->next, thread_index++) {
+
+		uint32_t end = tb->write_pos;
+		if (end == 0 || tb->generation != generation)
+			continue;
+
+		String tid = itos(thread_index);
+		String thread_name = tb->thread == Thread::get_main_id() ? String("Main Thread") : "Thread " + tid;
+		f->store_string(String(first ? "" : ",\n") + "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + tid + ",\"args\":{\"name\":\"" + thread_name + "\"}}");
+		first = false;
+
+		uint32_t count = MIN(end, (uint32_t)THREAD_BUFFER_SIZE);
+		for (uint32_t i = end - count; i != end; i++) {
+
+			const Event &e = tb->events[i & (THREAD_BUFFER_SIZE - 1)];
+			if (e.begin < capture_begin)
+				continue; // left over from a scope opened before the capture
+
+			f->store_string(",\n{\"name\":\"" + String(e.name).json_escape() + "\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":0,\"tid\":" + tid + ",\"ts\":" + itos(e.begin - capture_begin) + ",\"dur\":" + itos(e.end - e.begin) + "}");
+		}
+	}
+
+	if (buffers_mutex)
+		buffers_mutex->unlock();
+
+	f->store_string("\n],\"displayTimeUnit\":\"ms\"}\n");
+	f->close();
+	memdelete(f);
+
+	return OK;
+}
+
+void Profiler::initialize() {
+
+	buffers_mutex = Mutex::create();
+}
+
+void Profiler::finalize() {
+
+	stop_capture();
+
+	while (buffers) {
+		ThreadBuffer *next = buffers->next;
+		memdelete(buffers);
+		buffers = next;
+	}
+
+	if (buffers_mutex) {
+		memdelete(buffers_mutex);
+		buffers_mutex = NULL;
+	}
+}
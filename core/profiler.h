@@ -0,0 +1,135 @@
+/*************************************************************************/
+/*  profiler.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "os/mutex.h"
+#include "os/thread.h"
+#include "typedefs.h"
+#include "ustring.h"
+
+/**
+ * Hierarchical scope timer. Code marks regions with PROFILE_SCOPE(name),
+ * every thread appends finished scopes to its own ring buffer without
+ * taking locks, and a capture of N frames can be written out as a Chrome
+ * trace (chrome://tracing, Perfetto). Scopes compile out without DEBUG_ENABLED.
+ *
+ * The capture state is a generation counter, odd while capturing. A thread
+ * only writes to its buffer while flagged as writing and after checking the
+ * generation, and empties the buffer itself when it sees a new capture, so
+ * start and stop never touch a buffer another thread is filling. Stopping
+ * waits for writes in flight, so the buffers are settled once it returns.
+ */
+
+class Profiler {
+public:
+	enum {
+		THREAD_BUFFER_SIZE = 16384, // events kept per thread, power of two
+	};
+
+	struct Event {
+		const char *name; // must outlive the capture, scopes use string literals
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	struct ThreadBuffer {
+		Thread::ID thread;
+		uint32_t generation; // capture the events belong to
+		uint32_t write_pos; // only advanced by the owning thread
+		uint32_t writing; // set by the owning thread around a write
+		Event events[THREAD_BUFFER_SIZE];
+		ThreadBuffer *next;
+	};
+
+private:
+	static uint32_t capture_generation;
+	static int frames_left;
+	static uint64_t capture_begin;
+	static ThreadBuffer *buffers;
+	static Mutex *buffers_mutex;
+
+	static ThreadBuffer *_get_thread_buffer();
+
+public:
+	_FORCE_INLINE_ static bool is_capturing() { return static_cast<uint32_t const volatile &>(capture_generation) & 1; }
+
+	static uint64_t get_ticks_usec();
+	static void record(const char *p_name, uint64_t p_begin, uint64_t p_end);
+
+	static void start_capture(int p_frames);
+	static void stop_capture();
+	static void frame_mark();
+
+	static Error save_chrome_trace(const String &p_path);
+
+	static void initialize();
+	static void finalize();
+};
+
+class ProfilerScope {
+
+	const char *name;
+	uint64_t begin;
+
+public:
+	_FORCE_INLINE_ ProfilerScope(const char *p_name) {
+
+		if (Profiler::is_capturing()) {
+			name = p_name;
+			begin = Profiler::get_ticks_usec();
+		} else {
+			name = NULL;
+		}
+	}
+
+	_FORCE_INLINE_ ~ProfilerScope() {
+
+		if (name)
+			Profiler::record(name, begin, Profiler::get_ticks_usec());
+	}
+};
+
+#ifdef DEBUG_ENABLED
+
+#define _PROFILE_SCOPE_VAR(m_line) _profile_scope_##m_line
+#define _PROFILE_SCOPE_LINE(m_name, m_line) ProfilerScope _PROFILE_SCOPE_VAR(m_line)(m_name)
+#define PROFILE_SCOPE(m_name) _PROFILE_SCOPE_LINE(m_name, __LINE__)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+
+#else
+
+#define PROFILE_SCOPE(m_name)
+#define PROFILE_FUNCTION()
+
+#endif
+
+#endif // PROFILER_H
@@ -44,8 +44,10 @@
 #include "math/triangle_mesh.h"
 #include "os/input.h"
 #include "os/main_loop.h"
+#include "os/worker_thread_pool.h"
 #include "packed_data_container.h"
 #include "path_remap.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "undo_redo.h"
 static ResourceFormatImporter *resource_format_importer = NULL;
@@ -59,6 +61,8 @@ static _Marshalls *_marshalls = NULL;
 
 static _Geometry *_geometry = NULL;
 
+static WorkerThreadPool *worker_thread_pool = NULL;
+
 extern Mutex *_global_mutex;
 
 extern void register_global_constants();
@@ -74,6 +78,12 @@ void register_core_types() {
 
 	_global_mutex = Mutex::create();
 
+	Profiler::initialize();
+	ResourceLoader::initialize_threaded_loading();
+
+	// threads are started from Main::setup(), once the project settings are loaded
+	worker_thread_pool = memnew(WorkerThreadPool);
+
 	StringName::setup();
 
 	register_global_constants();
@@ -178,6 +188,10 @@ void unregister_core_types() {
 
 	memdelete(_geometry);
 
+	memdelete(worker_thread_pool);
+
+	Profiler::finalize();
+
 	if (resource_format_importer)
 		memdelete(resource_format_importer);
 
@@ -375,7 +375,7 @@ Resource::~Resource() {
 	}
 }
 
-HashMap<String, Resource *> ResourceCache::resources;
+OAHashMap<String, Resource *> ResourceCache::resources;
 
 RWLock *ResourceCache::lock = NULL;
 
@@ -414,15 +414,13 @@ Resource *ResourceCache::get(const String &p_path) {
 
 	lock->read_lock();
 
-	Resource **res = resources.getptr(p_path);
+	// read while locked, entries move around when the cache changes
+	Resource *res = NULL;
+	resources.lookup(p_path, &res);
 
 	lock->read_unlock();
 
-	if (!res) {
-		return NULL;
-	}
-
-	return *res;
+	return res;
 }
 
 void ResourceCache::get_cached_resources(List<Ref<Resource> > *p_resources) {
@@ -146,7 +146,7 @@ class ResourceCache {
 	friend class Resource;
 	friend class ResourceLoader; //need the lock
 	static RWLock *lock;
-	static HashMap<String, Resource *> resources;
+	static OAHashMap<String, Resource *> resources;
 	friend void unregister_core_types();
 	static void clear();
 	friend void register_core_types();
@@ -95,6 +95,18 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(register T *pw, register V v
 	return *pw;
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(register T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(register T *pw, register V val) {
+
+	*pw = val;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -150,6 +162,19 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(register T *pw, register V v
 	}
 }
 
+// For flags published once and then read often, without a full barrier on every read.
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(register T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(register T *pw, register V val) {
+
+	__atomic_store_n(pw, val, __ATOMIC_RELEASE);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -159,6 +184,8 @@ uint32_t atomic_increment(register uint32_t *pw);
 uint32_t atomic_sub(register uint32_t *pw, register uint32_t val);
 uint32_t atomic_add(register uint32_t *pw, register uint32_t val);
 uint32_t atomic_exchange_if_greater(register uint32_t *pw, register uint32_t val);
+uint32_t atomic_load_acquire(register uint32_t *pw);
+void atomic_store_release(register uint32_t *pw, register uint32_t val);
 
 uint64_t atomic_conditional_increment(register uint64_t *pw);
 uint64_t atomic_decrement(register uint64_t *pw);
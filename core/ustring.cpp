@@ -40,8 +40,14 @@
 #include "thirdparty/misc/md5.h"
 #include "thirdparty/misc/sha256.h"
 
+#include <string.h>
 #include <wchar.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USTRING_SSE2_ENABLED
+#include <emmintrin.h>
+#endif
+
 #ifndef NO_USE_STDLIB
 #include <stdio.h>
 #include <stdlib.h>
@@ -1285,6 +1291,115 @@ CharString String::ascii(bool p_allow_extended) const {
 	return cs;
 }
 
+/* ASCII runs are converted in bulk, 16 characters at a time with SSE2 or
+ * 8 bytes at a time otherwise, only other characters take the per-sequence path. */
+
+// Number of leading bytes below 0x80 (and not zero, which ends a C string).
+static _FORCE_INLINE_ int _ascii_run_length(const uint8_t *p_str, int p_len) {
+
+	int i = 0;
+
+#ifdef USTRING_SSE2_ENABLED
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p_str + i));
+		if (_mm_movemask_epi8(v) | _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)))
+			break;
+	}
+#else
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t w;
+		memcpy(&w, p_str + i, 8);
+		uint64_t has_zero = (w - 0x0101010101010101ULL) & ~w & 0x8080808080808080ULL;
+		if ((w & 0x8080808080808080ULL) | has_zero)
+			break;
+	}
+#endif
+
+	while (i < p_len && p_str[i] && p_str[i] < 0x80)
+		i++;
+
+	return i;
+}
+
+// Number of leading characters below 0x80.
+static _FORCE_INLINE_ int _ascii_run_length(const CharType *p_str, int p_len) {
+
+	int i = 0;
+
+#ifdef USTRING_SSE2_ENABLED
+	const __m128i zero = _mm_setzero_si128();
+	if (sizeof(CharType) == 4) {
+		const __m128i high = _mm_set1_epi32(~0x7F);
+		for (; i + 4 <= p_len; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(p_str + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, high), zero)) != 0xFFFF)
+				break;
+		}
+	} else {
+		const __m128i high = _mm_set1_epi16(~0x7F);
+		for (; i + 8 <= p_len; i += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(p_str + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, high), zero)) != 0xFFFF)
+				break;
+		}
+	}
+#endif
+
+	while (i < p_len && uint32_t(p_str[i]) < 0x80)
+		i++;
+
+	return i;
+}
+
+static _FORCE_INLINE_ void _ascii_widen(CharType *p_dst, const uint8_t *p_src, int p_len) {
+
+	int i = 0;
+
+#ifdef USTRING_SSE2_ENABLED
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p_src + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		if (sizeof(CharType) == 4) {
+			_mm_storeu_si128((__m128i *)(p_dst + i), _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128((__m128i *)(p_dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128((__m128i *)(p_dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128((__m128i *)(p_dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+		} else {
+			_mm_storeu_si128((__m128i *)(p_dst + i), lo);
+			_mm_storeu_si128((__m128i *)(p_dst + i + 8), hi);
+		}
+	}
+#endif
+
+	for (; i < p_len; i++)
+		p_dst[i] = p_src[i];
+}
+
+static _FORCE_INLINE_ void _ascii_narrow(uint8_t *p_dst, const CharType *p_src, int p_len) {
+
+	int i = 0;
+
+#ifdef USTRING_SSE2_ENABLED
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i lo, hi;
+		if (sizeof(CharType) == 4) {
+			lo = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(p_src + i)), _mm_loadu_si128((const __m128i *)(p_src + i + 4)));
+			hi = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(p_src + i + 8)), _mm_loadu_si128((const __m128i *)(p_src + i + 12)));
+		} else {
+			lo = _mm_loadu_si128((const __m128i *)(p_src + i));
+			hi = _mm_loadu_si128((const __m128i *)(p_src + i + 8));
+		}
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+
+	for (; i < p_len; i++)
+		p_dst[i] = p_src[i];
+}
+
 String String::utf8(const char *p_utf8, int p_len) {
 
 	String ret;
@@ -1315,6 +1430,27 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+	if (p_len < 0)
+		p_len = strlen(p_utf8);
+
+	{
+		/* Plain ASCII, nothing to decode */
+		int ascii = _ascii_run_length((const uint8_t *)p_utf8, p_len);
+		if (ascii == p_len || p_utf8[ascii] == 0) {
+
+			if (ascii == 0) {
+				clear();
+				return false;
+			}
+
+			resize(ascii + 1);
+			CharType *dst = &operator[](0);
+			_ascii_widen(dst, (const uint8_t *)p_utf8, ascii);
+			dst[ascii] = 0;
+			return false;
+		}
+	}
+
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
@@ -1326,9 +1462,13 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 				uint8_t c = *ptrtmp;
 
 				/* Determine the number of characters in sequence */
-				if ((c & 0x80) == 0)
-					skip = 0;
-				else if ((c & 0xE0) == 0xC0)
+				if ((c & 0x80) == 0) {
+					int run = _ascii_run_length((const uint8_t *)ptrtmp, ptrtmp_limit - ptrtmp);
+					str_size += run;
+					cstr_size += run;
+					ptrtmp += run;
+					continue;
+				} else if ((c & 0xE0) == 0xC0)
 					skip = 1;
 				else if ((c & 0xF0) == 0xE0)
 					skip = 2;
@@ -1380,9 +1520,17 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		int len = 0;
 
 		/* Determine the number of characters in sequence */
-		if ((*p_utf8 & 0x80) == 0)
+		if ((*p_utf8 & 0x80) == 0) {
+			int run = _ascii_run_length((const uint8_t *)p_utf8, cstr_size);
+			if (run > 1) {
+				_ascii_widen(dst, (const uint8_t *)p_utf8, run);
+				dst += run;
+				p_utf8 += run;
+				cstr_size -= run;
+				continue;
+			}
 			len = 1;
-		else if ((*p_utf8 & 0xE0) == 0xC0)
+		} else if ((*p_utf8 & 0xE0) == 0xC0)
 			len = 2;
 		else if ((*p_utf8 & 0xF0) == 0xE0)
 			len = 3;
@@ -1453,13 +1601,27 @@ CharString String::utf8() const {
 		return CharString();
 
 	const CharType *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+
+	int ascii = _ascii_run_length(d, l);
+	if (ascii == l) {
+		/* Plain ASCII, nothing to encode */
+		CharString utf8s;
+		utf8s.resize(l + 1);
+		uint8_t *cdst = (uint8_t *)utf8s.get_data();
+		_ascii_narrow(cdst, d, l);
+		cdst[l] = 0;
+		return utf8s;
+	}
+
+	int fl = ascii;
+	for (int i = ascii; i < l; i++) {
 
 		uint32_t c = d[i];
-		if (c <= 0x7f) // 7 bits.
-			fl += 1;
-		else if (c <= 0x7ff) { // 11 bits
+		if (c <= 0x7f) { // 7 bits.
+			int run = _ascii_run_length(d + i, l - i);
+			fl += run;
+			i += run - 1;
+		} else if (c <= 0x7ff) { // 11 bits
 			fl += 2;
 		} else if (c <= 0xffff) { // 16 bits
 			fl += 3;
@@ -1487,9 +1649,12 @@ CharString String::utf8() const {
 
 		uint32_t c = d[i];
 
-		if (c <= 0x7f) // 7 bits.
-			APPEND_CHAR(c);
-		else if (c <= 0x7ff) { // 11 bits
+		if (c <= 0x7f) { // 7 bits.
+			int run = _ascii_run_length(d + i, l - i);
+			_ascii_narrow(cdst, d + i, run);
+			cdst += run;
+			i += run - 1;
+		} else if (c <= 0x7ff) { // 11 bits
 
 			APPEND_CHAR(uint32_t(0xc0 | ((c >> 6) & 0x1f))); // Top 5 bits.
 			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
@@ -30,6 +30,7 @@
 
 #include "rasterizer_canvas_gles3.h"
 #include "os/os.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "rasterizer_scene_gles3.h"
 #include "servers/visual/visual_server_raster.h"
@@ -160,6 +161,7 @@ void RasterizerCanvasGLES3::canvas_begin() {
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::SHADOW_FILTER_PCF13, false);
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, false);
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_NINEPATCH, false);
+	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_STYLE_RECT, false);
 
 	state.canvas_shader.set_custom_shader(0);
 	state.canvas_shader.bind();
@@ -180,6 +182,7 @@ void RasterizerCanvasGLES3::canvas_begin() {
 	glBindVertexArray(data.canvas_quad_array);
 	state.using_texture_rect = true;
 	state.using_ninepatch = false;
+	state.using_style_rect = false;
 }
 
 void RasterizerCanvasGLES3::canvas_end() {
@@ -189,6 +192,7 @@ void RasterizerCanvasGLES3::canvas_end() {
 
 	state.using_texture_rect = false;
 	state.using_ninepatch = false;
+	state.using_style_rect = false;
 }
 
 RasterizerStorageGLES3::Texture *RasterizerCanvasGLES3::_bind_canvas_texture(const RID &p_texture, const RID &p_normal_map) {
@@ -214,6 +218,8 @@ RasterizerStorageGLES3::Texture *RasterizerCanvasGLES3::_bind_canvas_texture(con
 			if (texture->render_target)
 				texture->render_target->used_in_frame = true;
 
+			storage->texture_mark_used(texture);
+
 			glActiveTexture(GL_TEXTURE0);
 			glBindTexture(GL_TEXTURE_2D, texture->tex_id);
 			state.current_tex = p_texture;
@@ -247,6 +253,7 @@ RasterizerStorageGLES3::Texture *RasterizerCanvasGLES3::_bind_canvas_texture(con
 		} else {
 
 			normal_map = normal_map->get_ptr();
+			storage->texture_mark_used(normal_map);
 			glActiveTexture(GL_TEXTURE1);
 			glBindTexture(GL_TEXTURE_2D, normal_map->tex_id);
 			state.current_normal = p_normal_map;
@@ -264,9 +271,9 @@ RasterizerStorageGLES3::Texture *RasterizerCanvasGLES3::_bind_canvas_texture(con
 	return tex_return;
 }
 
-void RasterizerCanvasGLES3::_set_texture_rect_mode(bool p_enable, bool p_ninepatch) {
+void RasterizerCanvasGLES3::_set_texture_rect_mode(bool p_enable, bool p_ninepatch, bool p_style_rect) {
 
-	if (state.using_texture_rect == p_enable && state.using_ninepatch == p_ninepatch)
+	if (state.using_texture_rect == p_enable && state.using_ninepatch == p_ninepatch && state.using_style_rect == p_style_rect)
 		return;
 
 	if (p_enable) {
@@ -279,6 +286,7 @@ void RasterizerCanvasGLES3::_set_texture_rect_mode(bool p_enable, bool p_ninepat
 	}
 
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_NINEPATCH, p_ninepatch && p_enable);
+	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_STYLE_RECT, p_style_rect && p_enable);
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_TEXTURE_RECT, p_enable);
 	state.canvas_shader.bind();
 	state.canvas_shader.set_uniform(CanvasShaderGLES3::FINAL_MODULATE, state.canvas_item_modulate);
@@ -291,6 +299,7 @@ void RasterizerCanvasGLES3::_set_texture_rect_mode(bool p_enable, bool p_ninepat
 	}
 	state.using_texture_rect = p_enable;
 	state.using_ninepatch = p_ninepatch;
+	state.using_style_rect = p_style_rect;
 }
 
 void RasterizerCanvasGLES3::_draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor) {
@@ -699,6 +708,36 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 				storage->frame.canvas_draw_commands++;
 			} break;
 
+			case Item::Command::TYPE_STYLE_RECT: {
+
+				Item::CommandStyleRect *style = static_cast<Item::CommandStyleRect *>(c);
+
+				_set_texture_rect_mode(true, false, true);
+
+				glVertexAttrib4f(VS::ARRAY_COLOR, 1, 1, 1, 1);
+				_bind_canvas_texture(RID(), RID());
+
+				// one quad covering the shadow and the fading edge, the shape
+				// itself is resolved in the fragment shader
+				Rect2 dst_rect = style->get_draw_rect();
+
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::DST_RECT, Color(dst_rect.position.x, dst_rect.position.y, dst_rect.size.x, dst_rect.size.y));
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::SRC_RECT, Color(0, 0, 1, 1));
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::CLIP_RECT_UV, false);
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_RECT, Color(style->rect.position.x, style->rect.position.y, style->rect.size.x, style->rect.size.y));
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_BORDER, Color(style->border[MARGIN_LEFT], style->border[MARGIN_TOP], style->border[MARGIN_RIGHT], style->border[MARGIN_BOTTOM]));
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_CORNER_RADIUS, Color(style->corner_radius[CORNER_TOP_LEFT], style->corner_radius[CORNER_TOP_RIGHT], style->corner_radius[CORNER_BOTTOM_RIGHT], style->corner_radius[CORNER_BOTTOM_LEFT]));
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_COLOR, style->color);
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_BORDER_COLOR, style->border_color);
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_SHADOW_COLOR, style->shadow_color);
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_SHADOW_SIZE, style->shadow_size);
+				state.canvas_shader.set_uniform(CanvasShaderGLES3::STYLE_AA_SIZE, style->aa_size);
+
+				glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+				storage->frame.canvas_draw_commands++;
+			} break;
+
 			case Item::Command::TYPE_PRIMITIVE: {
 
 				Item::CommandPrimitive *primitive = static_cast<Item::CommandPrimitive *>(c);
@@ -1044,6 +1083,8 @@ void RasterizerCanvasGLES3::_copy_texscreen(const Rect2 &p_rect) {
 
 void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, const Color &p_modulate, Light *p_light, const Transform2D &p_transform) {
 
+	PROFILE_SCOPE("RasterizerCanvasGLES3::canvas_render_items");
+
 	Item *current_clip = NULL;
 	RasterizerStorageGLES3::Shader *shader_cache = NULL;
 
@@ -1179,6 +1220,7 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 					}
 
 					t = t->get_ptr();
+					storage->texture_mark_used(t);
 
 					if (storage->config.srgb_decode_supported && t->using_srgb) {
 						//no srgb in 2D
@@ -1362,6 +1404,7 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 						glBindTexture(GL_TEXTURE_2D, storage->resources.white_tex);
 					} else {
 
+						storage->texture_mark_used(t);
 						glBindTexture(t->target, t->tex_id);
 					}
 
@@ -1848,6 +1891,24 @@ void RasterizerCanvasGLES3::initialize() {
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_PIXEL_SNAP, GLOBAL_DEF("rendering/quality/2d/use_pixel_snap", false));
 }
 
+void RasterizerCanvasGLES3::precompile_shaders() {
+
+	// the variants nearly every 2D frame uses, on top of the project wide
+	// conditionals set in initialize()
+	uint32_t base = state.canvas_shader.get_version();
+
+	Vector<uint32_t> versions;
+	versions.push_back(base);
+	versions.push_back(base | (1 << CanvasShaderGLES3::USE_TEXTURE_RECT));
+	versions.push_back(base | (1 << CanvasShaderGLES3::USE_TEXTURE_RECT) | (1 << CanvasShaderGLES3::USE_NINEPATCH));
+	versions.push_back(base | (1 << CanvasShaderGLES3::USE_TEXTURE_RECT) | (1 << CanvasShaderGLES3::USE_STYLE_RECT));
+	versions.push_back(base | (1 << CanvasShaderGLES3::USE_DISTANCE_FIELD));
+	versions.push_back(base | (1 << CanvasShaderGLES3::USE_TEXTURE_RECT) | (1 << CanvasShaderGLES3::USE_DISTANCE_FIELD));
+
+	state.canvas_shader.precompile(versions);
+	state.canvas_shadow_shader.precompile();
+}
+
 void RasterizerCanvasGLES3::finalize() {
 
 	glDeleteBuffers(1, &data.canvas_quad_vertices);
@@ -74,6 +74,7 @@ public:
 
 		bool using_texture_rect;
 		bool using_ninepatch;
+		bool using_style_rect;
 
 		RID current_tex;
 		RID current_normal;
@@ -119,7 +120,7 @@ public:
 	virtual void canvas_begin();
 	virtual void canvas_end();
 
-	_FORCE_INLINE_ void _set_texture_rect_mode(bool p_enable, bool p_ninepatch = false);
+	_FORCE_INLINE_ void _set_texture_rect_mode(bool p_enable, bool p_ninepatch = false, bool p_style_rect = false);
 	_FORCE_INLINE_ RasterizerStorageGLES3::Texture *_bind_canvas_texture(const RID &p_texture, const RID &p_normal_map);
 
 	_FORCE_INLINE_ void _draw_gui_primitive(int p_points, const Vector2 *p_vertices, const Color *p_colors, const Vector2 *p_uvs);
@@ -139,6 +140,7 @@ public:
 	void draw_generic_textured_rect(const Rect2 &p_rect, const Rect2 &p_src);
 
 	void initialize();
+	void precompile_shaders();
 	void finalize();
 
 	virtual void draw_window_margins(int *black_margin, RID *black_image);
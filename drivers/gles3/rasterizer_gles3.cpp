@@ -187,9 +187,32 @@ void RasterizerGLES3::initialize() {
 
 	const GLubyte *renderer = glGetString(GL_RENDERER);
 	print_line("OpenGL ES 3.0 Renderer: " + String((const char *)renderer));
+
+	if (GLOBAL_GET("rendering/gles3/shader_cache/enabled")) {
+
+		bool program_binary = true; // core in GLES 3.0
+#ifdef GLAD_ENABLED
+		program_binary = GLAD_GL_ARB_get_program_binary;
+#endif
+		GLint formats = 0;
+		if (program_binary) {
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		}
+
+		if (formats > 0) {
+			ShaderGLES3::set_program_cache_path(OS::get_singleton()->get_user_data_dir().plus_file("shader_cache"));
+		} else if (OS::get_singleton()->is_stdout_verbose()) {
+			print_line("Driver can't retrieve program binaries, shader cache disabled");
+		}
+	}
+
 	storage->initialize();
 	canvas->initialize();
 	scene->initialize();
+
+	if (GLOBAL_GET("rendering/gles3/shader_cache/precompile_at_startup")) {
+		canvas->precompile_shaders();
+	}
 }
 
 void RasterizerGLES3::begin_frame() {
@@ -222,6 +245,7 @@ void RasterizerGLES3::begin_frame() {
 	storage->frame.prev_tick = tick;
 
 	storage->update_dirty_resources();
+	storage->update_texture_residency();
 
 	storage->info.render_final = storage->info.render;
 	storage->info.render.reset();
@@ -392,6 +416,8 @@ void RasterizerGLES3::register_config() {
 	GLOBAL_DEF("rendering/quality/filters/anisotropic_filter_level", 4);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/filters/anisotropic_filter_level", PropertyInfo(Variant::INT, "rendering/quality/filters/anisotropic_filter_level", PROPERTY_HINT_RANGE, "1,16,1"));
 	GLOBAL_DEF("rendering/limits/time/time_rollover_secs", 3600);
+	GLOBAL_DEF("rendering/gles3/shader_cache/enabled", true);
+	GLOBAL_DEF("rendering/gles3/shader_cache/precompile_at_startup", true);
 }
 
 RasterizerGLES3::RasterizerGLES3() {
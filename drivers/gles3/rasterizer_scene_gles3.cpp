@@ -31,6 +31,7 @@
 #include "rasterizer_scene_gles3.h"
 #include "math_funcs.h"
 #include "os/os.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "rasterizer_canvas_gles3.h"
 #include "servers/visual/visual_server_raster.h"
@@ -1228,6 +1229,7 @@ bool RasterizerSceneGLES3::_setup_material(RasterizerStorageGLES3::Material *p_m
 			if (t->render_target)
 				t->render_target->used_in_frame = true;
 
+			storage->texture_mark_used(t);
 			target = t->target;
 			tex = t->tex_id;
 		}
@@ -1532,6 +1534,7 @@ void RasterizerSceneGLES3::_render_geometry(RenderList::Element *e) {
 						t->render_target->used_in_frame = true;
 					}
 
+					storage->texture_mark_used(t);
 					glActiveTexture(GL_TEXTURE0);
 					glBindTexture(t->target, t->tex_id);
 					restore_tex = true;
@@ -1849,6 +1852,7 @@ void RasterizerSceneGLES3::_setup_light(RenderList::Element *e, const Transform
 		RasterizerStorageGLES3::LightmapCapture *capture = storage->lightmap_capture_data_owner.getornull(e->instance->lightmap_capture->base);
 
 		if (lightmap && capture) {
+			storage->texture_mark_used(lightmap);
 			glActiveTexture(GL_TEXTURE0 + storage->config.max_texture_image_units - 9);
 			glBindTexture(GL_TEXTURE_2D, lightmap->tex_id);
 			state.scene_shader.set_uniform(SceneShaderGLES3::LIGHTMAP_ENERGY, capture->energy);
@@ -2338,6 +2342,7 @@ void RasterizerSceneGLES3::_draw_sky(RasterizerStorageGLES3::Sky *p_sky, const C
 	RasterizerStorageGLES3::Texture *tex = storage->texture_owner.getornull(p_sky->panorama);
 
 	ERR_FAIL_COND(!tex);
+	storage->texture_mark_used(tex);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(tex->target, tex->tex_id);
 
@@ -3923,6 +3928,7 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 		RasterizerStorageGLES3::Texture *tex = storage->texture_owner.getornull(env->color_correction);
 		if (tex) {
 			state.tonemap_shader.set_conditional(TonemapShaderGLES3::USE_COLOR_CORRECTION, true);
+			storage->texture_mark_used(tex);
 			glActiveTexture(GL_TEXTURE3);
 			glBindTexture(tex->target, tex->tex_id);
 		}
@@ -3981,6 +3987,8 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 
 void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_ortogonal, InstanceBase **p_cull_result, int p_cull_count, RID *p_light_cull_result, int p_light_cull_count, RID *p_reflection_probe_cull_result, int p_reflection_probe_cull_count, RID p_environment, RID p_shadow_atlas, RID p_reflection_atlas, RID p_reflection_probe, int p_reflection_probe_pass) {
 
+	PROFILE_SCOPE("RasterizerSceneGLES3::render_scene");
+
 	//first of all, make a new render pass
 	render_pass++;
 
@@ -609,6 +609,14 @@ void RasterizerStorageGLES3::texture_allocate(RID p_texture, int p_width, int p_
 
 	Texture *texture = texture_owner.get(p_texture);
 	ERR_FAIL_COND(!texture);
+
+	if (texture->evicted) {
+		// the old contents are being replaced, nothing left to stream back
+		info.texture_mem_evicted -= texture->total_data_size;
+		info.texture_mem += texture->total_data_size;
+		texture->evicted = false;
+	}
+
 	texture->width = p_width;
 	texture->height = p_height;
 	texture->format = p_format;
@@ -647,8 +655,13 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 	ERR_FAIL_COND(!texture);
 	ERR_FAIL_COND(!texture->active);
 	ERR_FAIL_COND(texture->render_target);
-	ERR_FAIL_COND(texture->format != p_image->get_format());
 	ERR_FAIL_COND(p_image.is_null());
+	ERR_FAIL_COND(texture->format != p_image->get_format());
+
+	_texture_upload(texture, p_image, p_cube_side);
+}
+
+void RasterizerStorageGLES3::_texture_upload(Texture *p_texture, const Ref<Image> &p_image, VS::CubeMapSide p_cube_side) {
 
 	GLenum type;
 	GLenum format;
@@ -656,70 +669,76 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 	bool compressed;
 	bool srgb;
 
-	if (config.keep_original_textures && !(texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING)) {
-		texture->images[p_cube_side] = p_image;
+	if (p_texture->evicted) {
+		info.texture_mem_evicted -= p_texture->total_data_size;
+		info.texture_mem += p_texture->total_data_size;
+		p_texture->evicted = false;
+	}
+
+	if (!(p_texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING) && (config.keep_original_textures || (config.texture_residency_budget && p_texture->target == GL_TEXTURE_2D))) {
+		p_texture->images[p_cube_side] = p_image;
 	}
 
-	Ref<Image> img = _get_gl_image_and_format(p_image, p_image->get_format(), texture->flags, format, internal_format, type, compressed, srgb);
+	Ref<Image> img = _get_gl_image_and_format(p_image, p_image->get_format(), p_texture->flags, format, internal_format, type, compressed, srgb);
 
-	if (config.shrink_textures_x2 && (p_image->has_mipmaps() || !p_image->is_compressed()) && !(texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING)) {
+	if (config.shrink_textures_x2 && (p_image->has_mipmaps() || !p_image->is_compressed()) && !(p_texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING)) {
 
-		texture->alloc_height = MAX(1, texture->alloc_height / 2);
-		texture->alloc_width = MAX(1, texture->alloc_width / 2);
+		p_texture->alloc_height = MAX(1, p_texture->alloc_height / 2);
+		p_texture->alloc_width = MAX(1, p_texture->alloc_width / 2);
 
-		if (texture->alloc_width == img->get_width() / 2 && texture->alloc_height == img->get_height() / 2) {
+		if (p_texture->alloc_width == img->get_width() / 2 && p_texture->alloc_height == img->get_height() / 2) {
 
 			img->shrink_x2();
 		} else if (img->get_format() <= Image::FORMAT_RGBA8) {
 
-			img->resize(texture->alloc_width, texture->alloc_height, Image::INTERPOLATE_BILINEAR);
+			img->resize(p_texture->alloc_width, p_texture->alloc_height, Image::INTERPOLATE_BILINEAR);
 		}
 	};
 
-	GLenum blit_target = (texture->target == GL_TEXTURE_CUBE_MAP) ? _cube_side_enum[p_cube_side] : GL_TEXTURE_2D;
+	GLenum blit_target = (p_texture->target == GL_TEXTURE_CUBE_MAP) ? _cube_side_enum[p_cube_side] : GL_TEXTURE_2D;
 
-	texture->data_size = img->get_data().size();
+	p_texture->data_size = img->get_data().size();
 	PoolVector<uint8_t>::Read read = img->get_data().read();
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(texture->target, texture->tex_id);
+	glBindTexture(p_texture->target, p_texture->tex_id);
 
-	texture->ignore_mipmaps = compressed && !img->has_mipmaps();
+	p_texture->ignore_mipmaps = compressed && !img->has_mipmaps();
 
-	if ((texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && !texture->ignore_mipmaps)
-		glTexParameteri(texture->target, GL_TEXTURE_MIN_FILTER, config.use_fast_texture_filter ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+	if ((p_texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && !p_texture->ignore_mipmaps)
+		glTexParameteri(p_texture->target, GL_TEXTURE_MIN_FILTER, config.use_fast_texture_filter ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
 	else {
-		if (texture->flags & VS::TEXTURE_FLAG_FILTER) {
-			glTexParameteri(texture->target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		if (p_texture->flags & VS::TEXTURE_FLAG_FILTER) {
+			glTexParameteri(p_texture->target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		} else {
-			glTexParameteri(texture->target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(p_texture->target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		}
 	}
 
 	if (config.srgb_decode_supported && srgb) {
 
-		if (texture->flags & VS::TEXTURE_FLAG_CONVERT_TO_LINEAR) {
+		if (p_texture->flags & VS::TEXTURE_FLAG_CONVERT_TO_LINEAR) {
 
-			glTexParameteri(texture->target, _TEXTURE_SRGB_DECODE_EXT, _DECODE_EXT);
-			texture->using_srgb = true;
+			glTexParameteri(p_texture->target, _TEXTURE_SRGB_DECODE_EXT, _DECODE_EXT);
+			p_texture->using_srgb = true;
 		} else {
-			glTexParameteri(texture->target, _TEXTURE_SRGB_DECODE_EXT, _SKIP_DECODE_EXT);
-			texture->using_srgb = false;
+			glTexParameteri(p_texture->target, _TEXTURE_SRGB_DECODE_EXT, _SKIP_DECODE_EXT);
+			p_texture->using_srgb = false;
 		}
 	}
 
-	if (texture->flags & VS::TEXTURE_FLAG_FILTER) {
+	if (p_texture->flags & VS::TEXTURE_FLAG_FILTER) {
 
-		glTexParameteri(texture->target, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Linear Filtering
+		glTexParameteri(p_texture->target, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Linear Filtering
 
 	} else {
 
-		glTexParameteri(texture->target, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // raw Filtering
+		glTexParameteri(p_texture->target, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // raw Filtering
 	}
 
-	if (((texture->flags & VS::TEXTURE_FLAG_REPEAT) || (texture->flags & VS::TEXTURE_FLAG_MIRRORED_REPEAT)) && texture->target != GL_TEXTURE_CUBE_MAP) {
+	if (((p_texture->flags & VS::TEXTURE_FLAG_REPEAT) || (p_texture->flags & VS::TEXTURE_FLAG_MIRRORED_REPEAT)) && p_texture->target != GL_TEXTURE_CUBE_MAP) {
 
-		if (texture->flags & VS::TEXTURE_FLAG_MIRRORED_REPEAT) {
+		if (p_texture->flags & VS::TEXTURE_FLAG_MIRRORED_REPEAT) {
 			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
 			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		} else {
@@ -728,49 +747,49 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 		}
 	} else {
 
-		//glTexParameterf( texture->target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
-		glTexParameterf(texture->target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameterf(texture->target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		//glTexParameterf( p_texture->target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+		glTexParameterf(p_texture->target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameterf(p_texture->target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	}
 
 //set swizle for older format compatibility
 #ifdef GLES_OVER_GL
-	switch (texture->format) {
+	switch (p_texture->format) {
 
 		case Image::FORMAT_L8: {
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_G, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_B, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_A, GL_ONE);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_G, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_B, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_A, GL_ONE);
 
 		} break;
 		case Image::FORMAT_LA8: {
 
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_G, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_B, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_G, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_B, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
 		} break;
 		default: {
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_G, GL_GREEN);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_B, GL_BLUE);
-			glTexParameteri(texture->target, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_R, GL_RED);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_G, GL_GREEN);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_B, GL_BLUE);
+			glTexParameteri(p_texture->target, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
 
 		} break;
 	}
 #endif
 	if (config.use_anisotropic_filter) {
 
-		if (texture->flags & VS::TEXTURE_FLAG_ANISOTROPIC_FILTER) {
+		if (p_texture->flags & VS::TEXTURE_FLAG_ANISOTROPIC_FILTER) {
 
-			glTexParameterf(texture->target, _GL_TEXTURE_MAX_ANISOTROPY_EXT, config.anisotropic_level);
+			glTexParameterf(p_texture->target, _GL_TEXTURE_MAX_ANISOTROPY_EXT, config.anisotropic_level);
 		} else {
-			glTexParameterf(texture->target, _GL_TEXTURE_MAX_ANISOTROPY_EXT, 1);
+			glTexParameterf(p_texture->target, _GL_TEXTURE_MAX_ANISOTROPY_EXT, 1);
 		}
 	}
 
-	int mipmaps = ((texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && img->has_mipmaps()) ? img->get_mipmap_count() + 1 : 1;
+	int mipmaps = ((p_texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && img->has_mipmaps()) ? img->get_mipmap_count() + 1 : 1;
 
 	int w = img->get_width();
 	int h = img->get_height();
@@ -784,7 +803,7 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 
 		//print_line("mipmap: "+itos(i)+" size: "+itos(size)+" w: "+itos(mm_w)+", h: "+itos(mm_h));
 
-		if (texture->compressed) {
+		if (p_texture->compressed) {
 			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 			int bw = w;
@@ -794,7 +813,7 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 
 		} else {
 			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-			if (texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING) {
+			if (p_texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING) {
 				glTexSubImage2D(blit_target, i, 0, 0, w, h, format, type, &read[ofs]);
 			} else {
 				glTexImage2D(blit_target, i, internal_format, w, h, 0, format, type, &read[ofs]);
@@ -806,25 +825,98 @@ void RasterizerStorageGLES3::texture_set_data(RID p_texture, const Ref<Image> &p
 		h = MAX(1, h >> 1);
 	}
 
-	info.texture_mem -= texture->total_data_size;
-	texture->total_data_size = tsize;
-	info.texture_mem += texture->total_data_size;
+	info.texture_mem -= p_texture->total_data_size;
+	p_texture->total_data_size = tsize;
+	info.texture_mem += p_texture->total_data_size;
 
 	//printf("texture: %i x %i - size: %i - total: %i\n",texture->width,texture->height,tsize,_rinfo.texture_mem);
 
-	texture->stored_cube_sides |= (1 << p_cube_side);
+	p_texture->stored_cube_sides |= (1 << p_cube_side);
 
-	if ((texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && mipmaps == 1 && !texture->ignore_mipmaps && (!(texture->flags & VS::TEXTURE_FLAG_CUBEMAP) || texture->stored_cube_sides == (1 << 6) - 1)) {
+	if ((p_texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && mipmaps == 1 && !p_texture->ignore_mipmaps && (!(p_texture->flags & VS::TEXTURE_FLAG_CUBEMAP) || p_texture->stored_cube_sides == (1 << 6) - 1)) {
 		//generate mipmaps if they were requested and the image does not contain them
-		glGenerateMipmap(texture->target);
+		glGenerateMipmap(p_texture->target);
 	} else if (mipmaps > 1) {
-		glTexParameteri(texture->target, GL_TEXTURE_BASE_LEVEL, 0);
-		glTexParameteri(texture->target, GL_TEXTURE_MAX_LEVEL, mipmaps - 1);
+		glTexParameteri(p_texture->target, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(p_texture->target, GL_TEXTURE_MAX_LEVEL, mipmaps - 1);
+	}
+
+	p_texture->mipmaps = mipmaps;
+
+	//texture_set_flags(p_texture,p_texture->flags);
+}
+
+void RasterizerStorageGLES3::_texture_make_resident(Texture *p_texture) {
+
+	if (p_texture->evicted) {
+
+		// may be called while binding to any unit, leave unit 0 as it was
+		GLint active_unit;
+		GLint bound;
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &active_unit);
+		glActiveTexture(GL_TEXTURE0);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+
+		_texture_upload(p_texture, p_texture->images[0], VS::CUBEMAP_LEFT);
+		info.render.texture_restream_count++;
+
+		glBindTexture(GL_TEXTURE_2D, bound);
+		glActiveTexture(active_unit);
+	}
+
+	bool can_evict = p_texture->target == GL_TEXTURE_2D && !p_texture->render_target && p_texture->images[0].is_valid() && !(p_texture->flags & VS::TEXTURE_FLAG_USED_FOR_STREAMING) && !config.shrink_textures_x2;
+
+	if (p_texture->residency_list.in_list()) {
+		_texture_residency_remove(p_texture);
 	}
 
-	texture->mipmaps = mipmaps;
+	if (can_evict) {
+		if (!texture_residency_list.first())
+			texture_residency_tail = &p_texture->residency_list;
+		texture_residency_list.add(&p_texture->residency_list);
+	}
+}
+
+void RasterizerStorageGLES3::_texture_residency_remove(Texture *p_texture) {
+
+	if (texture_residency_tail == &p_texture->residency_list)
+		texture_residency_tail = texture_residency_tail->prev();
+
+	texture_residency_list.remove(&p_texture->residency_list);
+}
+
+void RasterizerStorageGLES3::_texture_evict(Texture *p_texture) {
+
+	// A fresh name is the only portable way to make the driver release the storage,
+	// so the name changes. texture_get_texid() uploads it again and returns the new one.
+	glDeleteTextures(1, &p_texture->tex_id);
+	glGenTextures(1, &p_texture->tex_id);
+
+	p_texture->evicted = true;
+	p_texture->stored_cube_sides = 0;
+	info.texture_mem -= p_texture->total_data_size;
+	info.texture_mem_evicted += p_texture->total_data_size;
+
+	_texture_residency_remove(p_texture);
+}
+
+void RasterizerStorageGLES3::update_texture_residency() {
 
-	//texture_set_flags(p_texture,texture->flags);
+	if (!config.texture_residency_budget || info.texture_mem <= config.texture_residency_budget)
+		return;
+
+	SelfList<Texture> *E = texture_residency_tail;
+
+	// walk from the least recently used end, never drop what the last frame drew
+	while (E && info.texture_mem > config.texture_residency_budget) {
+
+		Texture *t = E->self();
+		if (t->used_frame + 1 >= frame.count)
+			break;
+
+		E = E->prev();
+		_texture_evict(t);
+	}
 }
 
 Ref<Image> RasterizerStorageGLES3::texture_get_data(RID p_texture, VS::CubeMapSide p_cube_side) const {
@@ -924,9 +1016,15 @@ void RasterizerStorageGLES3::texture_set_flags(RID p_texture, uint32_t p_flags)
 
 	bool had_mipmaps = texture->flags & VS::TEXTURE_FLAG_MIPMAPS;
 
+	uint32_t cube = texture->flags & VS::TEXTURE_FLAG_CUBEMAP;
+
+	if (texture->evicted) {
+		texture->flags = p_flags | cube; // applied when uploaded again
+		return;
+	}
+
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(texture->target, texture->tex_id);
-	uint32_t cube = texture->flags & VS::TEXTURE_FLAG_CUBEMAP;
 	texture->flags = p_flags | cube; // can't remove a cube from being a cube
 
 	if (((texture->flags & VS::TEXTURE_FLAG_REPEAT) || (texture->flags & VS::TEXTURE_FLAG_MIRRORED_REPEAT)) && texture->target != GL_TEXTURE_CUBE_MAP) {
@@ -1011,6 +1109,9 @@ uint32_t RasterizerStorageGLES3::texture_get_texid(RID p_texture) const {
 
 	ERR_FAIL_COND_V(!texture, 0);
 
+	// the caller is about to use the name, and eviction would have replaced it
+	const_cast<RasterizerStorageGLES3 *>(this)->texture_mark_used(texture);
+
 	return texture->tex_id;
 }
 uint32_t RasterizerStorageGLES3::texture_get_width(RID p_texture) const {
@@ -1130,6 +1231,8 @@ RID RasterizerStorageGLES3::texture_create_radiance_cubemap(RID p_source, int p_
 	glDisable(GL_SCISSOR_TEST);
 	glDisable(GL_BLEND);
 
+	const_cast<RasterizerStorageGLES3 *>(this)->texture_mark_used(texture);
+
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(texture->target, texture->tex_id);
 
@@ -1297,6 +1400,8 @@ void RasterizerStorageGLES3::sky_set_texture(RID p_sky, RID p_panorama, int p_ra
 		ERR_FAIL_COND(!texture);
 	}
 
+	texture_mark_used(texture);
+
 	glBindVertexArray(0);
 	glDisable(GL_CULL_FACE);
 	glDisable(GL_DEPTH_TEST);
@@ -5823,6 +5928,7 @@ void RasterizerStorageGLES3::update_particles() {
 
 				} else {
 
+					texture_mark_used(t);
 					target = t->target;
 					tex = t->tex_id;
 				}
@@ -6776,7 +6882,14 @@ bool RasterizerStorageGLES3::free(RID p_rid) {
 		// delete the texture
 		Texture *texture = texture_owner.get(p_rid);
 		ERR_FAIL_COND_V(texture->render_target, true); //can't free the render target texture, dude
-		info.texture_mem -= texture->total_data_size;
+		if (texture->evicted) {
+			info.texture_mem_evicted -= texture->total_data_size;
+		} else {
+			info.texture_mem -= texture->total_data_size;
+		}
+		if (texture->residency_list.in_list()) {
+			_texture_residency_remove(texture);
+		}
 		texture_owner.free(p_rid);
 		memdelete(texture);
 	} else if (sky_owner.owns(p_rid)) {
@@ -7077,6 +7190,10 @@ int RasterizerStorageGLES3::get_render_info(VS::RenderInfo p_info) {
 			return info.texture_mem;
 		case VS::INFO_VERTEX_MEM_USED:
 			return info.vertex_mem;
+		case VS::INFO_TEXTURE_MEM_EVICTED:
+			return info.texture_mem_evicted;
+		case VS::INFO_TEXTURES_RESTREAMED_IN_FRAME:
+			return info.render_final.texture_restream_count;
 		default:
 			return 0; //no idea either
 	}
@@ -7269,10 +7386,12 @@ void RasterizerStorageGLES3::initialize() {
 #endif
 
 	frame.count = 0;
+	texture_residency_tail = NULL;
 	frame.prev_tick = 0;
 	frame.delta = 0;
 	frame.current_rt = NULL;
 	config.keep_original_textures = false;
+	config.texture_residency_budget = uint64_t(MAX(0, int(GLOBAL_GET("rendering/limits/texture_residency/budget_mb")))) * 1024 * 1024;
 	config.generate_wireframes = false;
 	config.use_texture_array_environment = GLOBAL_GET("rendering/quality/reflections/texture_array_reflections");
 
@@ -95,6 +95,8 @@ public:
 
 		bool keep_original_textures;
 
+		uint64_t texture_residency_budget; // bytes, 0 when disabled
+
 		bool no_depth_prepass;
 		bool force_vertex_shading;
 	} config;
@@ -134,6 +136,7 @@ public:
 	struct Info {
 
 		uint64_t texture_mem;
+		uint64_t texture_mem_evicted;
 		uint64_t vertex_mem;
 
 		struct Render {
@@ -143,6 +146,7 @@ public:
 			uint32_t surface_switch_count;
 			uint32_t shader_rebind_count;
 			uint32_t vertices_count;
+			uint32_t texture_restream_count;
 
 			void reset() {
 				object_count = 0;
@@ -151,12 +155,14 @@ public:
 				surface_switch_count = 0;
 				shader_rebind_count = 0;
 				vertices_count = 0;
+				texture_restream_count = 0;
 			}
 		} render, render_final, snap;
 
 		Info() {
 
 			texture_mem = 0;
+			texture_mem_evicted = 0;
 			vertex_mem = 0;
 			render.reset();
 			render_final.reset();
@@ -275,6 +281,11 @@ public:
 
 		Ref<Image> images[6];
 
+		// residency, see texture_mark_used()
+		uint64_t used_frame;
+		bool evicted;
+		SelfList<Texture> residency_list;
+
 		VisualServer::TextureDetectCallback detect_3d;
 		void *detect_3d_ud;
 
@@ -284,7 +295,8 @@ public:
 		VisualServer::TextureDetectCallback detect_normal;
 		void *detect_normal_ud;
 
-		Texture() {
+		Texture() :
+				residency_list(this) {
 
 			using_srgb = false;
 			stored_cube_sides = 0;
@@ -299,6 +311,8 @@ public:
 			total_data_size = 0;
 			target = GL_TEXTURE_2D;
 			mipmaps = 0;
+			used_frame = 0;
+			evicted = false;
 			detect_3d = NULL;
 			detect_3d_ud = NULL;
 			detect_srgb = NULL;
@@ -335,6 +349,27 @@ public:
 
 	mutable RID_Owner<Texture> texture_owner;
 
+	// Canvas textures whose GL storage may be released under the budget,
+	// most recently used first. The CPU image is kept to upload them again.
+	SelfList<Texture>::List texture_residency_list;
+	SelfList<Texture> *texture_residency_tail; // least recently used, the list has no back pointer
+
+	void _texture_upload(Texture *p_texture, const Ref<Image> &p_image, VS::CubeMapSide p_cube_side);
+	void _texture_make_resident(Texture *p_texture);
+	void _texture_evict(Texture *p_texture);
+	void _texture_residency_remove(Texture *p_texture);
+
+	_FORCE_INLINE_ void texture_mark_used(Texture *p_texture) {
+
+		if (!config.texture_residency_budget || p_texture->used_frame == frame.count)
+			return;
+
+		p_texture->used_frame = frame.count;
+		_texture_make_resident(p_texture);
+	}
+
+	void update_texture_residency();
+
 	Ref<Image> _get_gl_image_and_format(const Ref<Image> &p_image, Image::Format p_format, uint32_t p_flags, GLenum &r_gl_format, GLenum &r_gl_internal_format, GLenum &r_gl_type, bool &r_compressed, bool &srgb);
 
 	virtual RID texture_create();
@@ -30,6 +30,8 @@
 
 #include "shader_gles3.h"
 
+#include "os/dir_access.h"
+#include "os/file_access.h"
 #include "print_string.h"
 
 //#define DEBUG_OPENGL
@@ -50,6 +52,11 @@
 #endif
 
 ShaderGLES3 *ShaderGLES3::active = NULL;
+String ShaderGLES3::program_cache_path;
+uint64_t ShaderGLES3::program_cache_driver_hash = 0;
+
+#define PROGRAM_CACHE_MAGIC 0x42505351 // "QSPB"
+#define PROGRAM_CACHE_FORMAT_VERSION 2
 
 //#define DEBUG_SHADER
 
@@ -239,6 +246,9 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	CharString code_string2;
 	CharString code_globals;
 	CharString material_string;
+	CharString light_string;
+	CharString fragment_globals;
+	CharString fragment_material_string;
 
 	//print_line("code version? "+itos(conditional_version.code_version));
 
@@ -311,50 +321,7 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	}
 #endif
 
-	v.vert_id = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(v.vert_id, strings.size(), &strings[0], NULL);
-	glCompileShader(v.vert_id);
-
-	GLint status;
-
-	glGetShaderiv(v.vert_id, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE) {
-		// error compiling
-		GLsizei iloglen;
-		glGetShaderiv(v.vert_id, GL_INFO_LOG_LENGTH, &iloglen);
-
-		if (iloglen < 0) {
-
-			glDeleteShader(v.vert_id);
-			glDeleteProgram(v.id);
-			v.id = 0;
-
-			ERR_PRINT("Vertex shader compilation failed with empty log");
-		} else {
-
-			if (iloglen == 0) {
-
-				iloglen = 4096; //buggy driver (Adreno 220+....)
-			}
-
-			char *ilogmem = (char *)memalloc(iloglen + 1);
-			ilogmem[iloglen] = 0;
-			glGetShaderInfoLog(v.vert_id, iloglen, &iloglen, ilogmem);
-
-			String err_string = get_shader_name() + ": Vertex Program Compilation Failed:\n";
-
-			err_string += ilogmem;
-			_display_error_with_code(err_string, strings);
-			memfree(ilogmem);
-			glDeleteShader(v.vert_id);
-			glDeleteProgram(v.id);
-			v.id = 0;
-		}
-
-		ERR_FAIL_V(NULL);
-	}
-
-	//_display_error_with_code("pepo", strings);
+	Vector<const char *> vertex_strings = strings;
 
 	/* FRAGMENT SHADER */
 
@@ -370,22 +337,22 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 
 	strings.push_back(fragment_code0.get_data());
 	if (cc) {
-		material_string = cc->uniforms.ascii();
-		strings.push_back(material_string.get_data());
+		fragment_material_string = cc->uniforms.ascii();
+		strings.push_back(fragment_material_string.get_data());
 	}
 
 	strings.push_back(fragment_code1.get_data());
 
 	if (cc) {
-		code_globals = cc->fragment_globals.ascii();
-		strings.push_back(code_globals.get_data());
+		fragment_globals = cc->fragment_globals.ascii();
+		strings.push_back(fragment_globals.get_data());
 	}
 
 	strings.push_back(fragment_code2.get_data());
 
 	if (cc) {
-		code_string = cc->light.ascii();
-		strings.push_back(code_string.get_data());
+		light_string = cc->light.ascii();
+		strings.push_back(light_string.get_data());
 	}
 
 	strings.push_back(fragment_code3.get_data());
@@ -398,7 +365,7 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	strings.push_back(fragment_code4.get_data());
 
 #ifdef DEBUG_SHADER
-	DEBUG_PRINT("\nFragment Globals:\n\n" + String(code_globals.get_data()));
+	DEBUG_PRINT("\nFragment Globals:\n\n" + String(fragment_globals.get_data()));
 	DEBUG_PRINT("\nFragment Code:\n\n" + String(code_string2.get_data()));
 	for (int i = 0; i < strings.size(); i++) {
 
@@ -406,114 +373,182 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	}
 #endif
 
-	v.frag_id = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(v.frag_id, strings.size(), &strings[0], NULL);
-	glCompileShader(v.frag_id);
+	// every piece of source is known now, try the program binary cache first
+	uint64_t cache_key = 0;
+	bool from_cache = false;
+	if (program_cache_path != String()) {
+		cache_key = _get_program_cache_key(vertex_strings, strings);
+		from_cache = _load_program_binary(v.id, cache_key);
+	}
 
-	glGetShaderiv(v.frag_id, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE) {
-		// error compiling
-		GLsizei iloglen;
-		glGetShaderiv(v.frag_id, GL_INFO_LOG_LENGTH, &iloglen);
+	if (from_cache) {
 
-		if (iloglen < 0) {
+		v.vert_id = 0;
+		v.frag_id = 0;
+	} else {
 
-			glDeleteShader(v.frag_id);
-			glDeleteShader(v.vert_id);
-			glDeleteProgram(v.id);
-			v.id = 0;
-			ERR_PRINT("Fragment shader compilation failed with empty log");
-		} else {
+		v.vert_id = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(v.vert_id, vertex_strings.size(), &vertex_strings[0], NULL);
+		glCompileShader(v.vert_id);
 
-			if (iloglen == 0) {
+		GLint status;
 
-				iloglen = 4096; //buggy driver (Adreno 220+....)
+		glGetShaderiv(v.vert_id, GL_COMPILE_STATUS, &status);
+		if (status == GL_FALSE) {
+			// error compiling
+			GLsizei iloglen;
+			glGetShaderiv(v.vert_id, GL_INFO_LOG_LENGTH, &iloglen);
+
+			if (iloglen < 0) {
+
+				glDeleteShader(v.vert_id);
+				glDeleteProgram(v.id);
+				v.id = 0;
+
+				ERR_PRINT("Vertex shader compilation failed with empty log");
+			} else {
+
+				if (iloglen == 0) {
+
+					iloglen = 4096; //buggy driver (Adreno 220+....)
+				}
+
+				char *ilogmem = (char *)memalloc(iloglen + 1);
+				ilogmem[iloglen] = 0;
+				glGetShaderInfoLog(v.vert_id, iloglen, &iloglen, ilogmem);
+
+				String err_string = get_shader_name() + ": Vertex Program Compilation Failed:\n";
+
+				err_string += ilogmem;
+				_display_error_with_code(err_string, vertex_strings);
+				memfree(ilogmem);
+				glDeleteShader(v.vert_id);
+				glDeleteProgram(v.id);
+				v.id = 0;
 			}
 
-			char *ilogmem = (char *)memalloc(iloglen + 1);
-			ilogmem[iloglen] = 0;
-			glGetShaderInfoLog(v.frag_id, iloglen, &iloglen, ilogmem);
+			ERR_FAIL_V(NULL);
+		}
 
-			String err_string = get_shader_name() + ": Fragment Program Compilation Failed:\n";
+		//_display_error_with_code("pepo", strings);
 
-			err_string += ilogmem;
-			_display_error_with_code(err_string, strings);
-			ERR_PRINT(err_string.ascii().get_data());
-			memfree(ilogmem);
-			glDeleteShader(v.frag_id);
-			glDeleteShader(v.vert_id);
-			glDeleteProgram(v.id);
-			v.id = 0;
+		v.frag_id = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(v.frag_id, strings.size(), &strings[0], NULL);
+		glCompileShader(v.frag_id);
+
+		glGetShaderiv(v.frag_id, GL_COMPILE_STATUS, &status);
+		if (status == GL_FALSE) {
+			// error compiling
+			GLsizei iloglen;
+			glGetShaderiv(v.frag_id, GL_INFO_LOG_LENGTH, &iloglen);
+
+			if (iloglen < 0) {
+
+				glDeleteShader(v.frag_id);
+				glDeleteShader(v.vert_id);
+				glDeleteProgram(v.id);
+				v.id = 0;
+				ERR_PRINT("Fragment shader compilation failed with empty log");
+			} else {
+
+				if (iloglen == 0) {
+
+					iloglen = 4096; //buggy driver (Adreno 220+....)
+				}
+
+				char *ilogmem = (char *)memalloc(iloglen + 1);
+				ilogmem[iloglen] = 0;
+				glGetShaderInfoLog(v.frag_id, iloglen, &iloglen, ilogmem);
+
+				String err_string = get_shader_name() + ": Fragment Program Compilation Failed:\n";
+
+				err_string += ilogmem;
+				_display_error_with_code(err_string, strings);
+				ERR_PRINT(err_string.ascii().get_data());
+				memfree(ilogmem);
+				glDeleteShader(v.frag_id);
+				glDeleteShader(v.vert_id);
+				glDeleteProgram(v.id);
+				v.id = 0;
+			}
+
+			ERR_FAIL_V(NULL);
 		}
 
-		ERR_FAIL_V(NULL);
-	}
+		glAttachShader(v.id, v.frag_id);
+		glAttachShader(v.id, v.vert_id);
 
-	glAttachShader(v.id, v.frag_id);
-	glAttachShader(v.id, v.vert_id);
+		// bind attributes before linking
+		for (int i = 0; i < attribute_pair_count; i++) {
 
-	// bind attributes before linking
-	for (int i = 0; i < attribute_pair_count; i++) {
+			glBindAttribLocation(v.id, attribute_pairs[i].index, attribute_pairs[i].name);
+		}
 
-		glBindAttribLocation(v.id, attribute_pairs[i].index, attribute_pairs[i].name);
-	}
+		//if feedback exists, set it up
 
-	//if feedback exists, set it up
+		if (feedback_count) {
+			Vector<const char *> feedback;
+			for (int i = 0; i < feedback_count; i++) {
 
-	if (feedback_count) {
-		Vector<const char *> feedback;
-		for (int i = 0; i < feedback_count; i++) {
+				if (feedbacks[i].conditional == -1 || (1 << feedbacks[i].conditional) & conditional_version.version) {
+					//conditional for this feedback is enabled
+					feedback.push_back(feedbacks[i].name);
+				}
+			}
 
-			if (feedbacks[i].conditional == -1 || (1 << feedbacks[i].conditional) & conditional_version.version) {
-				//conditional for this feedback is enabled
-				feedback.push_back(feedbacks[i].name);
+			if (feedback.size()) {
+				glTransformFeedbackVaryings(v.id, feedback.size(), feedback.ptr(), GL_INTERLEAVED_ATTRIBS);
 			}
 		}
 
-		if (feedback.size()) {
-			glTransformFeedbackVaryings(v.id, feedback.size(), feedback.ptr(), GL_INTERLEAVED_ATTRIBS);
+		if (cache_key) {
+			glProgramParameteri(v.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		}
-	}
 
-	glLinkProgram(v.id);
+		glLinkProgram(v.id);
+
+		glGetProgramiv(v.id, GL_LINK_STATUS, &status);
 
-	glGetProgramiv(v.id, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE) {
+			// error linking
+			GLsizei iloglen;
+			glGetProgramiv(v.id, GL_INFO_LOG_LENGTH, &iloglen);
 
-	if (status == GL_FALSE) {
-		// error linking
-		GLsizei iloglen;
-		glGetProgramiv(v.id, GL_INFO_LOG_LENGTH, &iloglen);
+			if (iloglen < 0) {
 
-		if (iloglen < 0) {
+				glDeleteShader(v.frag_id);
+				glDeleteShader(v.vert_id);
+				glDeleteProgram(v.id);
+				v.id = 0;
+				ERR_FAIL_COND_V(iloglen <= 0, NULL);
+			}
+
+			if (iloglen == 0) {
 
+				iloglen = 4096; //buggy driver (Adreno 220+....)
+			}
+
+			char *ilogmem = (char *)Memory::alloc_static(iloglen + 1);
+			ilogmem[iloglen] = 0;
+			glGetProgramInfoLog(v.id, iloglen, &iloglen, ilogmem);
+
+			String err_string = get_shader_name() + ": Program LINK FAILED:\n";
+
+			err_string += ilogmem;
+			_display_error_with_code(err_string, strings);
+			ERR_PRINT(err_string.ascii().get_data());
+			Memory::free_static(ilogmem);
 			glDeleteShader(v.frag_id);
 			glDeleteShader(v.vert_id);
 			glDeleteProgram(v.id);
 			v.id = 0;
-			ERR_FAIL_COND_V(iloglen <= 0, NULL);
-		}
-
-		if (iloglen == 0) {
 
-			iloglen = 4096; //buggy driver (Adreno 220+....)
+			ERR_FAIL_V(NULL);
 		}
 
-		char *ilogmem = (char *)Memory::alloc_static(iloglen + 1);
-		ilogmem[iloglen] = 0;
-		glGetProgramInfoLog(v.id, iloglen, &iloglen, ilogmem);
-
-		String err_string = get_shader_name() + ": Program LINK FAILED:\n";
-
-		err_string += ilogmem;
-		_display_error_with_code(err_string, strings);
-		ERR_PRINT(err_string.ascii().get_data());
-		Memory::free_static(ilogmem);
-		glDeleteShader(v.frag_id);
-		glDeleteShader(v.vert_id);
-		glDeleteProgram(v.id);
-		v.id = 0;
-
-		ERR_FAIL_V(NULL);
+		if (cache_key) {
+			_save_program_binary(v.id, cache_key);
+		}
 	}
 
 	/* UNIFORMS */
@@ -563,9 +598,213 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 
 	v.ok = true;
 
+	if (cache_key && conditional_version.code_version == 0 && !cached_versions.has(conditional_version.version)) {
+		cached_versions.insert(conditional_version.version);
+		_append_cached_version(conditional_version.version);
+	}
+
 	return &v;
 }
 
+static uint64_t _hash_program_source(uint64_t p_hash, const char *p_str) {
+
+	// FNV-1a, 64 bits so distinct variants don't end up sharing a file
+	while (*p_str) {
+		p_hash ^= (uint8_t)*p_str++;
+		p_hash *= 1099511628211ULL;
+	}
+	return p_hash;
+}
+
+uint64_t ShaderGLES3::_get_program_cache_key(const Vector<const char *> &p_vertex_strings, const Vector<const char *> &p_fragment_strings) const {
+
+	uint64_t hash = 14695981039346656037ULL ^ program_cache_driver_hash;
+
+	hash = _hash_program_source(hash, get_shader_name().ascii().get_data());
+	for (int i = 0; i < p_vertex_strings.size(); i++) {
+		hash = _hash_program_source(hash, p_vertex_strings[i]);
+	}
+	hash = _hash_program_source(hash, "\nFRAGMENT\n");
+	for (int i = 0; i < p_fragment_strings.size(); i++) {
+		hash = _hash_program_source(hash, p_fragment_strings[i]);
+	}
+
+	// attribute locations and feedback varyings are baked into the binary too
+	for (int i = 0; i < attribute_pair_count; i++) {
+		hash = _hash_program_source(hash, attribute_pairs[i].name);
+		hash = hash_djb2_one_64(attribute_pairs[i].index, hash);
+	}
+	for (int i = 0; i < feedback_count; i++) {
+		if (feedbacks[i].conditional == -1 || (1 << feedbacks[i].conditional) & conditional_version.version) {
+			hash = _hash_program_source(hash, feedbacks[i].name);
+		}
+	}
+
+	return hash ? hash : 1; // zero means "not cached"
+}
+
+String ShaderGLES3::_get_program_cache_file(uint64_t p_key) const {
+
+	return program_cache_path.plus_file(get_shader_name() + "_" + String::num_uint64(p_key, 16) + ".bin");
+}
+
+bool ShaderGLES3::_load_program_binary(GLuint p_program, uint64_t p_key) {
+
+	FileAccess *f = FileAccess::open(_get_program_cache_file(p_key), FileAccess::READ);
+	if (!f)
+		return false;
+
+	bool ok = false;
+	if (f->get_32() == PROGRAM_CACHE_MAGIC && f->get_32() == PROGRAM_CACHE_FORMAT_VERSION) {
+
+		GLenum format = f->get_32();
+		uint32_t length = f->get_32();
+
+		if (length > 0 && length == f->get_len() - f->get_position()) {
+
+			Vector<uint8_t> binary;
+			binary.resize(length);
+			if (f->get_buffer(binary.ptrw(), length) == length) {
+
+				glProgramBinary(p_program, format, binary.ptr(), length);
+
+				GLint status = GL_FALSE;
+				glGetProgramiv(p_program, GL_LINK_STATUS, &status);
+				ok = status == GL_TRUE; // rejected after a driver update, for example
+			}
+		}
+	}
+
+	memdelete(f);
+	return ok;
+}
+
+void ShaderGLES3::_save_program_binary(GLuint p_program, uint64_t p_key) {
+
+	GLint length = 0;
+	glGetProgramiv(p_program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	Vector<uint8_t> binary;
+	binary.resize(length);
+	GLenum format = 0;
+	glGetProgramBinary(p_program, length, &length, &format, binary.ptrw());
+	if (length <= 0)
+		return;
+
+	FileAccess *f = FileAccess::open(_get_program_cache_file(p_key), FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	f->store_32(PROGRAM_CACHE_MAGIC);
+	f->store_32(PROGRAM_CACHE_FORMAT_VERSION);
+	f->store_32(format);
+	f->store_32(length);
+	f->store_buffer(binary.ptr(), length);
+	memdelete(f);
+}
+
+String ShaderGLES3::_get_cached_version_list_file() const {
+
+	// another driver, or another shader that happens to share the name,
+	// keeps a list of its own
+	uint64_t hash = 14695981039346656037ULL ^ program_cache_driver_hash;
+	hash = _hash_program_source(hash, vertex_code);
+	hash = _hash_program_source(hash, "\nFRAGMENT\n");
+	hash = _hash_program_source(hash, fragment_code);
+
+	return program_cache_path.plus_file(get_shader_name() + "_" + String::num_uint64(hash, 16) + ".variants");
+}
+
+void ShaderGLES3::_load_cached_version_list() {
+
+	cached_versions.clear();
+	cached_version_list_file = _get_cached_version_list_file();
+
+	FileAccess *f = FileAccess::open(cached_version_list_file, FileAccess::READ);
+	if (!f)
+		return;
+
+	bool valid = f->get_32() == PROGRAM_CACHE_MAGIC && f->get_32() == PROGRAM_CACHE_FORMAT_VERSION;
+	if (valid) {
+
+		// masks follow until the end, a torn last one is ignored
+		while (f->get_position() + 4 <= f->get_len()) {
+			cached_versions.insert(f->get_32());
+		}
+	}
+
+	memdelete(f);
+
+	if (!valid) {
+		// start over, or appending would never make it readable
+		DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+		da->remove(cached_version_list_file);
+		memdelete(da);
+	}
+}
+
+void ShaderGLES3::_append_cached_version(uint32_t p_version) {
+
+	// appended one at a time, so linking n variants writes O(n) and not O(n^2)
+	FileAccess *f = FileAccess::open(cached_version_list_file, FileAccess::READ_WRITE);
+	if (f) {
+		f->seek_end();
+	} else {
+		f = FileAccess::open(cached_version_list_file, FileAccess::WRITE);
+		ERR_FAIL_COND(!f);
+		f->store_32(PROGRAM_CACHE_MAGIC);
+		f->store_32(PROGRAM_CACHE_FORMAT_VERSION);
+	}
+
+	f->store_32(p_version);
+	memdelete(f);
+}
+
+void ShaderGLES3::set_program_cache_path(const String &p_path) {
+
+	program_cache_path = String();
+	if (p_path == String())
+		return;
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	Error err = da->make_dir_recursive(p_path);
+	memdelete(da);
+	ERR_FAIL_COND(err != OK);
+
+	// a binary is only valid for the driver that produced it
+	String driver = String((const char *)glGetString(GL_VENDOR)) + "|" + String((const char *)glGetString(GL_RENDERER)) + "|" + String((const char *)glGetString(GL_VERSION));
+	program_cache_driver_hash = driver.hash64();
+
+	program_cache_path = p_path;
+}
+
+void ShaderGLES3::precompile(const Vector<uint32_t> &p_versions) {
+
+	Set<uint32_t> versions = cached_versions;
+	for (int i = 0; i < p_versions.size(); i++) {
+		versions.insert(p_versions[i]);
+	}
+
+	VersionKey prev_version = conditional_version;
+
+	for (Set<uint32_t>::Element *E = versions.front(); E; E = E->next()) {
+
+		conditional_version.version = E->get();
+		conditional_version.code_version = 0;
+		if (!version_map.has(conditional_version)) {
+			get_current_version();
+		}
+	}
+
+	conditional_version = prev_version;
+
+	// compiling leaves no program bound, restore whatever was in use
+	if (active && active->version) {
+		glUseProgram(active->version->id);
+	}
+}
+
 GLint ShaderGLES3::get_uniform_location(const String &p_name) const {
 
 	ERR_FAIL_COND_V(!version, -1);
@@ -594,6 +833,10 @@ void ShaderGLES3::setup(const char **p_conditional_defines, int p_conditional_co
 	feedbacks = p_feedback;
 	feedback_count = p_feedback_count;
 
+	if (program_cache_path != String()) {
+		_load_cached_version_list();
+	}
+
 	//split vertex and shader code (thank you, shader compiler programmers from you know what company).
 	{
 		String globals_tag = "\nVERTEX_SHADER_GLOBALS";
@@ -43,6 +43,7 @@
 #include "camera_matrix.h"
 #include "hash_map.h"
 #include "map.h"
+#include "set.h"
 #include "variant.h"
 
 /**
@@ -191,6 +192,22 @@ private:
 
 	static ShaderGLES3 *active;
 
+	// linked programs are stored in program_cache_path keyed by driver and
+	// source, the conditional masks seen so far are appended to a list next
+	// to them (keyed the same way) so precompile() can bring them back at startup
+	static String program_cache_path;
+	static uint64_t program_cache_driver_hash;
+	Set<uint32_t> cached_versions;
+	String cached_version_list_file;
+
+	uint64_t _get_program_cache_key(const Vector<const char *> &p_vertex_strings, const Vector<const char *> &p_fragment_strings) const;
+	String _get_program_cache_file(uint64_t p_key) const;
+	bool _load_program_binary(GLuint p_program, uint64_t p_key);
+	void _save_program_binary(GLuint p_program, uint64_t p_key);
+	String _get_cached_version_list_file() const;
+	void _load_cached_version_list();
+	void _append_cached_version(uint32_t p_version);
+
 	int max_image_units;
 
 	_FORCE_INLINE_ void _set_uniform_variant(GLint p_uniform, const Variant &p_value) {
@@ -318,6 +335,9 @@ public:
 
 	void clear_caches();
 
+	static void set_program_cache_path(const String &p_path);
+	void precompile(const Vector<uint32_t> &p_versions = Vector<uint32_t>());
+
 	uint32_t create_custom_shader();
 	void set_custom_shader_code(uint32_t p_code_id, const String &p_vertex, const String &p_vertex_globals, const String &p_fragment, const String &p_light, const String &p_fragment_globals, const String &p_uniforms, const Vector<StringName> &p_texture_uniforms, const Vector<CharString> &p_custom_defines);
 	void set_custom_shader(uint32_t p_code_id);
@@ -50,6 +50,11 @@ out mediump vec4 color_interp;
 out highp vec2 pixel_size_interp;
 #endif
 
+#ifdef USE_STYLE_RECT
+
+out highp vec2 style_pos_interp;
+#endif
+
 
 #ifdef USE_LIGHTING
 
@@ -126,6 +131,10 @@ void main() {
 	}
 	highp vec4 outvec = vec4(dst_rect.xy + abs(dst_rect.zw) * mix(vertex,vec2(1.0,1.0)-vertex,lessThan(src_rect.zw,vec2(0.0,0.0))),0.0,1.0);
 
+#ifdef USE_STYLE_RECT
+	style_pos_interp = outvec.xy;
+#endif
+
 #else
 	uv_interp = uv_attrib;
 	highp vec4 outvec = vec4(vertex,0.0,1.0);
@@ -352,6 +361,65 @@ float map_ninepatch_axis(float pixel, float draw_size,float tex_pixel_size,float
 
 }
 
+#endif
+
+#ifdef USE_STYLE_RECT
+
+in highp vec2 style_pos_interp;
+
+//position and size of the styled rect, without shadow or anti-aliasing
+uniform highp vec4 style_rect;
+//left top right bottom
+uniform highp vec4 style_border;
+//top-left top-right bottom-right bottom-left
+uniform highp vec4 style_corner_radius;
+uniform mediump vec4 style_color;
+uniform mediump vec4 style_border_color;
+uniform mediump vec4 style_shadow_color;
+uniform highp float style_shadow_size;
+uniform highp float style_aa_size;
+
+//signed distance to a rect with a different radius on each corner
+highp float rounded_rect_distance(highp vec2 pos, highp vec4 rect, highp vec4 radius) {
+
+	highp vec2 half_size = rect.zw * 0.5;
+	highp vec2 p = pos - rect.xy - half_size;
+	highp float r = p.x < 0.0 ? (p.y < 0.0 ? radius.x : radius.w) : (p.y < 0.0 ? radius.y : radius.z);
+	highp vec2 q = abs(p) - half_size + vec2(r);
+	return min(max(q.x, q.y), 0.0) + length(max(q, vec2(0.0))) - r;
+}
+
+float style_coverage(highp float distance) {
+
+	if (style_aa_size > 0.0) {
+		return 1.0 - clamp(distance / style_aa_size, 0.0, 1.0);
+	} else {
+		return distance <= 0.0 ? 1.0 : 0.0;
+	}
+}
+
+vec4 style_rect_compute(highp vec2 pos) {
+
+	highp float outer = rounded_rect_distance(pos, style_rect, style_corner_radius);
+
+	highp vec4 inner_rect = vec4(style_rect.xy + style_border.xy, style_rect.zw - style_border.xy - style_border.zw);
+	highp vec4 inner_radius = max(style_corner_radius - min(style_border.yyww, style_border.xzzx), vec4(0.0));
+	highp float inner = rounded_rect_distance(pos, inner_rect, inner_radius);
+
+	//work premultiplied so transparent centers don't darken the border edge
+	vec4 center = vec4(style_color.rgb * style_color.a, style_color.a);
+	//with no border at all, inner == outer and the edge would pick up the border color
+	vec4 border = any(greaterThan(style_border, vec4(0.0))) ? vec4(style_border_color.rgb * style_border_color.a, style_border_color.a) : center;
+	vec4 shape = mix(border, center, style_coverage(inner)) * style_coverage(outer);
+
+	if (style_shadow_size > 0.0 && outer >= 0.0) {
+		float shadow_alpha = style_shadow_color.a * (1.0 - clamp(outer / style_shadow_size, 0.0, 1.0));
+		shape += vec4(style_shadow_color.rgb * shadow_alpha, shadow_alpha) * (1.0 - shape.a);
+	}
+
+	return vec4(shape.rgb / max(shape.a, 0.0001), shape.a);
+}
+
 #endif
 #endif
 
@@ -379,6 +447,10 @@ void main() {
 	uv = uv*src_rect.zw+src_rect.xy; //apply region if needed
 #endif
 
+#ifdef USE_STYLE_RECT
+	color *= style_rect_compute(style_pos_interp);
+#endif
+
 	if (clip_rect_uv) {
 
 		uv = clamp(uv,src_rect.xy,src_rect.xy+abs(src_rect.zw));
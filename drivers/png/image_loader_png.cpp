@@ -202,19 +202,6 @@ Error ImageLoaderPNG::_load_image(void *rf_up, png_rw_ptr p_func, Ref<Image> p_i
 	return OK;
 }
 
-Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
-
-	Error err = _load_image(f, _read_png_data, p_image);
-	f->close();
-
-	return err;
-}
-
-void ImageLoaderPNG::get_recognized_extensions(List<String> *p_extensions) const {
-
-	p_extensions->push_back("png");
-}
-
 struct PNGReadStatus {
 
 	uint32_t offset;
@@ -239,6 +226,32 @@ static void user_read_data(png_structp png_ptr, png_bytep data, png_size_t p_len
 	}
 }
 
+Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
+
+	Error err;
+
+	const uint8_t *mapped = f->get_mapped_region();
+	if (mapped) {
+		// decode straight from the mapped file instead of reading through it
+		size_t pos = f->get_position();
+		PNGReadStatus prs;
+		prs.image = mapped + pos;
+		prs.offset = 0;
+		prs.size = f->get_len() - pos;
+		err = _load_image(&prs, user_read_data, p_image);
+	} else {
+		err = _load_image(f, _read_png_data, p_image);
+	}
+	f->close();
+
+	return err;
+}
+
+void ImageLoaderPNG::get_recognized_extensions(List<String> *p_extensions) const {
+
+	p_extensions->push_back("png");
+}
+
 static Ref<Image> _load_mem_png(const uint8_t *p_png, int p_size) {
 
 	PNGReadStatus prs;
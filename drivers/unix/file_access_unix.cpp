@@ -38,6 +38,7 @@
 #include <sys/types.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -63,8 +64,20 @@ void FileAccessUnix::check_errors() const {
 	}
 }
 
+void FileAccessUnix::_unmap() {
+
+#if defined(UNIX_ENABLED)
+	if (mapped)
+		munmap(mapped, mapped_len);
+#endif
+	mapped = NULL;
+	mapped_len = 0;
+	map_failed = false;
+}
+
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 
+	_unmap();
 	if (f)
 		fclose(f);
 	f = NULL;
@@ -125,6 +138,7 @@ void FileAccessUnix::close() {
 	if (!f)
 		return;
 
+	_unmap();
 	fclose(f);
 	f = NULL;
 
@@ -219,6 +233,26 @@ int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 };
 
+const uint8_t *FileAccessUnix::get_mapped_region() const {
+
+#if defined(UNIX_ENABLED)
+	// mapped on first request only, regular reads keep going through stdio
+	if (mapped || map_failed || !f || flags != READ)
+		return mapped;
+
+	size_t len = get_len();
+	void *region = len ? mmap(NULL, len, PROT_READ, MAP_PRIVATE, fileno(f), 0) : MAP_FAILED;
+	if (region == MAP_FAILED) {
+		map_failed = true;
+		return NULL;
+	}
+
+	mapped = (uint8_t *)region;
+	mapped_len = len;
+#endif
+	return mapped;
+}
+
 Error FileAccessUnix::get_error() const {
 
 	return last_error;
@@ -306,6 +340,9 @@ FileAccessUnix::FileAccessUnix() {
 
 	f = NULL;
 	flags = 0;
+	mapped = NULL;
+	mapped_len = 0;
+	map_failed = false;
 	last_error = OK;
 }
 
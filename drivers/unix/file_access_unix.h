@@ -47,7 +47,11 @@ class FileAccessUnix : public FileAccess {
 
 	FILE *f;
 	int flags;
+	mutable uint8_t *mapped;
+	mutable size_t mapped_len;
+	mutable bool map_failed;
 	void check_errors() const;
+	void _unmap();
 	mutable Error last_error;
 	String save_path;
 	String path;
@@ -70,6 +74,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_mapped_region() const;
 
 	virtual Error get_error() const; ///< get last error
 
@@ -498,6 +498,104 @@ bool InputDefault::is_emulating_touchscreen() const {
 	return emulate_touch;
 }
 
+void InputDefault::set_use_accumulated_input(bool p_enable) {
+
+	_THREAD_SAFE_METHOD_
+
+	use_accumulated_input = p_enable;
+	if (!use_accumulated_input)
+		flush_accumulated_events();
+}
+
+bool InputDefault::is_using_accumulated_input() const {
+
+	return use_accumulated_input;
+}
+
+void InputDefault::set_keep_accumulated_history(bool p_enable) {
+
+	keep_accumulated_history = p_enable;
+}
+
+bool InputDefault::is_keeping_accumulated_history() const {
+
+	return keep_accumulated_history;
+}
+
+void InputDefault::accumulate_input_event(const Ref<InputEvent> &p_event) {
+
+	ERR_FAIL_COND(p_event.is_null());
+
+	_THREAD_SAFE_METHOD_
+
+	if (!use_accumulated_input) {
+		parse_input_event(p_event);
+		return;
+	}
+
+	// Anything that can't be merged stays queued behind the pending events,
+	// so the order in which the main loop sees them does not change.
+	if (accumulated_events.size() && accumulated_events.back()->get()->accumulate(p_event))
+		return;
+
+	if (keep_accumulated_history) {
+		Ref<InputEventMouseMotion> mm = p_event;
+		if (mm.is_valid() && mm->get_position_history().size() == 0) {
+			PoolVector2Array history;
+			history.push_back(mm->get_position());
+			mm->set_position_history(history);
+		}
+	}
+
+	accumulated_events.push_back(p_event);
+}
+
+void InputDefault::flush_accumulated_events() {
+
+	_THREAD_SAFE_METHOD_
+
+	while (accumulated_events.front()) {
+		// Pop before dispatching, handlers may feed new events back in.
+		Ref<InputEvent> event = accumulated_events.front()->get();
+		accumulated_events.pop_front();
+		parse_input_event(event);
+	}
+}
+
+Ref<InputEventMouseMotion> InputDefault::create_mouse_motion() {
+
+	_THREAD_SAFE_METHOD_
+
+	// An event is free again once the pool holds the only reference to it,
+	// anything still kept around by the scene or by scripts is left alone.
+	for (int i = 0; i < mouse_motion_pool.size(); i++) {
+
+		Ref<InputEventMouseMotion> mm = mouse_motion_pool[i];
+		if (mm->reference_get_count() != 2) // the pool and the local above
+			continue;
+
+		mm->set_device(0);
+		mm->set_shift(false);
+		mm->set_alt(false);
+		mm->set_control(false);
+		mm->set_metakey(false);
+		mm->set_button_mask(0);
+		mm->set_position(Vector2());
+		mm->set_global_position(Vector2());
+		mm->set_relative(Vector2());
+		mm->set_speed(Vector2());
+		mm->set_position_history(PoolVector2Array());
+		return mm;
+	}
+
+	Ref<InputEventMouseMotion> mm;
+	mm.instance();
+	if (mouse_motion_pool.size() < MOUSE_MOTION_POOL_SIZE)
+		mouse_motion_pool.push_back(mm);
+
+	return mm;
+}
+
 void InputDefault::set_custom_mouse_cursor(const RES &p_cursor, CursorShape p_shape, const Vector2 &p_hotspot) {
 	if (Engine::get_singleton()->is_editor_hint())
 		return;
@@ -815,6 +913,8 @@ InputDefault::InputDefault() {
 
 	mouse_button_mask = 0;
 	emulate_touch = false;
+	use_accumulated_input = false;
+	keep_accumulated_history = false;
 	main_loop = NULL;
 
 	hat_map_default[HAT_UP].type = TYPE_BUTTON;
@@ -61,6 +61,15 @@ class InputDefault : public Input {
 
 	bool emulate_touch;
 
+	enum {
+		MOUSE_MOTION_POOL_SIZE = 8,
+	};
+
+	bool use_accumulated_input;
+	bool keep_accumulated_history;
+	List<Ref<InputEvent> > accumulated_events;
+	Vector<Ref<InputEventMouseMotion> > mouse_motion_pool;
+
 	struct VibrationInfo {
 		float weak_magnitude;
 		float strong_magnitude;
@@ -206,6 +215,10 @@ public:
 
 	virtual void parse_input_event(const Ref<InputEvent> &p_event);
 
+	void accumulate_input_event(const Ref<InputEvent> &p_event);
+	void flush_accumulated_events();
+	Ref<InputEventMouseMotion> create_mouse_motion();
+
 	void set_gravity(const Vector3 &p_gravity);
 	void set_accelerometer(const Vector3 &p_accel);
 	void set_magnetometer(const Vector3 &p_magnetometer);
@@ -226,6 +239,12 @@ public:
 	void set_emulate_touch(bool p_emulate);
 	virtual bool is_emulating_touchscreen() const;
 
+	void set_use_accumulated_input(bool p_enable);
+	bool is_using_accumulated_input() const;
+
+	void set_keep_accumulated_history(bool p_enable);
+	bool is_keeping_accumulated_history() const;
+
 	virtual void set_custom_mouse_cursor(const RES &p_cursor, CursorShape p_shape = Input::CURSOR_ARROW, const Vector2 &p_hotspot = Vector2());
 	virtual void set_mouse_in_window(bool p_in_window);
 
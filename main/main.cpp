@@ -36,7 +36,9 @@
 #include "message_queue.h"
 #include "modules/register_module_types.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "platform/register_platform_apis.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "scene/register_scene_types.h"
 #include "servers/register_server_types.h"
@@ -556,6 +558,10 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 		OS::get_singleton()->_render_thread_mode = OS::RenderThreadMode(rtm);
 	}
 
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads", PropertyInfo(Variant::INT, "threading/worker_pool/max_threads", PROPERTY_HINT_RANGE, "-1,128,1"));
+	WorkerThreadPool::get_singleton()->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	/* Determine audio and video drivers */
 
 	for (int i = 0; i < OS::get_singleton()->get_video_driver_count(); i++) {
@@ -672,6 +678,12 @@ error:
 	return ERR_INVALID_PARAMETER;
 }
 
+static void _sync_visual_server() {
+
+	// runs the commands queued by loading threads, some of them wait for a reply
+	VisualServer::get_singleton()->sync();
+}
+
 Error Main::setup2(Thread::ID p_main_tid_override) {
 
 	if (p_main_tid_override) {
@@ -686,6 +698,8 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		OS::get_singleton()->set_window_position(init_custom_pos);
 	}
 
+	ResourceLoader::set_threaded_load_wait_func(_sync_visual_server);
+
 	// right moment to create and initialize the audio server
 
 	audio_server = memnew(AudioServer);
@@ -730,6 +744,14 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		}
 	}
 
+	if (Input::get_singleton()) {
+		InputDefault *id = Object::cast_to<InputDefault>(Input::get_singleton());
+		if (id) {
+			id->set_use_accumulated_input(GLOBAL_DEF("input_devices/pointing/use_accumulated_input", false));
+			id->set_keep_accumulated_history(GLOBAL_DEF("input_devices/pointing/keep_accumulated_history", false));
+		}
+	}
+
 	MAIN_PRINT("Main: Load Scene Types");
 
 	register_scene_types();
@@ -770,6 +792,7 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	locale = String();
 
 	ClassDB::set_current_api(ClassDB::API_NONE); //no more api is registered at this point
+	ClassDB::seal();
 
 	if (OS::get_singleton()->is_stdout_verbose()) {
 		print_line("CORE API HASH: " + itos(ClassDB::get_api_hash(ClassDB::API_CORE)));
@@ -935,6 +958,9 @@ static uint64_t idle_process_max = 0;
 
 bool Main::iteration() {
 
+	Profiler::frame_mark();
+	PROFILE_SCOPE("Main::iteration");
+
 	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 
@@ -982,6 +1008,8 @@ bool Main::iteration() {
 	OS::get_singleton()->get_main_loop()->idle(step * time_scale);
 	message_queue->flush();
 
+	ResourceLoader::poll_threaded_loads();
+
 	VisualServer::get_singleton()->sync(); //sync if still drawing from previous frames.
 
 	if (OS::get_singleton()->can_draw() && !disable_render_loop) {
@@ -1061,6 +1089,10 @@ void Main::cleanup() {
 
 	ERR_FAIL_COND(!_start_success);
 
+	// background loads still running use the format loaders and the message queue
+	ResourceLoader::finalize_threaded_loading();
+	ResourceLoader::set_threaded_load_wait_func(NULL);
+
 	message_queue->flush();
 	memdelete(message_queue);
 
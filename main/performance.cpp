@@ -31,6 +31,7 @@
 #include "performance.h"
 #include "message_queue.h"
 #include "os/os.h"
+#include "profiler.h"
 #include "scene/main/scene_tree.h"
 #include "servers/visual_server.h"
 Performance *Performance::singleton = NULL;
@@ -39,6 +40,17 @@ void Performance::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &Performance::get_monitor);
 
+	ClassDB::bind_method(D_METHOD("add_custom_monitor", "id", "target", "method"), &Performance::add_custom_monitor);
+	ClassDB::bind_method(D_METHOD("remove_custom_monitor", "id"), &Performance::remove_custom_monitor);
+	ClassDB::bind_method(D_METHOD("has_custom_monitor", "id"), &Performance::has_custom_monitor);
+	ClassDB::bind_method(D_METHOD("get_custom_monitor", "id"), &Performance::get_custom_monitor);
+	ClassDB::bind_method(D_METHOD("get_custom_monitor_names"), &Performance::_get_custom_monitor_names);
+
+	ClassDB::bind_method(D_METHOD("start_trace_capture", "frames"), &Performance::start_trace_capture);
+	ClassDB::bind_method(D_METHOD("stop_trace_capture"), &Performance::stop_trace_capture);
+	ClassDB::bind_method(D_METHOD("is_capturing_trace"), &Performance::is_capturing_trace);
+	ClassDB::bind_method(D_METHOD("save_trace", "path"), &Performance::save_trace);
+
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
 	BIND_ENUM_CONSTANT(TIME_FIXED_PROCESS);
@@ -60,6 +72,9 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(RENDER_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(RENDER_VERTEX_MEM_USED);
 	BIND_ENUM_CONSTANT(RENDER_USAGE_VIDEO_MEM_TOTAL);
+	BIND_ENUM_CONSTANT(RENDER_2D_COMMAND_ALLOCATIONS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_TEXTURE_MEM_EVICTED);
+	BIND_ENUM_CONSTANT(RENDER_TEXTURES_RESTREAMED_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -90,6 +105,15 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"video/texture_mem",
 		"video/vertex_mem",
 		"video/video_mem_max",
+		"physics_2d/active_objects",
+		"physics_2d/collision_pairs",
+		"physics_2d/islands",
+		"physics_3d/active_objects",
+		"physics_3d/collision_pairs",
+		"physics_3d/islands",
+		"raster/2d_command_allocs",
+		"video/texture_mem_evicted",
+		"video/textures_restreamed",
 	};
 
 	return names[p_monitor];
@@ -126,6 +150,9 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case RENDER_TEXTURE_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_USED);
 		case RENDER_VERTEX_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_VERTEX_MEM_USED);
 		case RENDER_USAGE_VIDEO_MEM_TOTAL: return VS::get_singleton()->get_render_info(VS::INFO_USAGE_VIDEO_MEM_TOTAL);
+		case RENDER_2D_COMMAND_ALLOCATIONS_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_2D_COMMAND_ALLOCATIONS_IN_FRAME);
+		case RENDER_TEXTURE_MEM_EVICTED: return VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_EVICTED);
+		case RENDER_TEXTURES_RESTREAMED_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_TEXTURES_RESTREAMED_IN_FRAME);
 
 		default: {}
 	}
@@ -165,6 +192,9 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
@@ -181,9 +211,139 @@ void Performance::set_fixed_process_time(float p_pt) {
 	_fixed_process_time = p_pt;
 }
 
+void Performance::add_custom_monitor(const StringName &p_id, Object *p_target, const StringName &p_method) {
+
+	ERR_FAIL_NULL(p_target);
+
+	CustomMonitor monitor;
+	monitor.target = p_target->get_instance_id();
+	monitor.method = p_method;
+	monitor.func = NULL;
+	monitor.userdata = NULL;
+
+	custom_monitors_mutex->lock();
+	if (custom_monitors.has(p_id)) {
+		custom_monitors_mutex->unlock();
+		ERR_EXPLAIN("Custom monitor already exists: " + String(p_id));
+		ERR_FAIL();
+	}
+	custom_monitors[p_id] = monitor;
+	custom_monitors_mutex->unlock();
+}
+
+void Performance::add_custom_monitor_func(const StringName &p_id, CustomMonitorFunc p_func, void *p_userdata) {
+
+	ERR_FAIL_COND(!p_func);
+
+	CustomMonitor monitor;
+	monitor.target = 0;
+	monitor.func = p_func;
+	monitor.userdata = p_userdata;
+
+	custom_monitors_mutex->lock();
+	if (custom_monitors.has(p_id)) {
+		custom_monitors_mutex->unlock();
+		ERR_EXPLAIN("Custom monitor already exists: " + String(p_id));
+		ERR_FAIL();
+	}
+	custom_monitors[p_id] = monitor;
+	custom_monitors_mutex->unlock();
+}
+
+void Performance::remove_custom_monitor(const StringName &p_id) {
+
+	custom_monitors_mutex->lock();
+	bool removed = custom_monitors.erase(p_id);
+	custom_monitors_mutex->unlock();
+
+	ERR_FAIL_COND(!removed);
+}
+
+bool Performance::has_custom_monitor(const StringName &p_id) const {
+
+	custom_monitors_mutex->lock();
+	bool found = custom_monitors.has(p_id);
+	custom_monitors_mutex->unlock();
+
+	return found;
+}
+
+float Performance::get_custom_monitor(const StringName &p_id) const {
+
+	custom_monitors_mutex->lock();
+	const Map<StringName, CustomMonitor>::Element *E = custom_monitors.find(p_id);
+	if (!E) {
+		custom_monitors_mutex->unlock();
+		ERR_FAIL_V(0);
+	}
+	// copied so the callback runs unlocked and may add or remove monitors itself
+	CustomMonitor monitor = E->get();
+	custom_monitors_mutex->unlock();
+
+	if (monitor.func)
+		return monitor.func(monitor.userdata);
+
+	Object *target = ObjectDB::get_instance(monitor.target);
+	if (!target)
+		return 0;
+
+	return target->call(monitor.method);
+}
+
+void Performance::get_custom_monitor_names(List<StringName> *r_names) const {
+
+	custom_monitors_mutex->lock();
+	for (const Map<StringName, CustomMonitor>::Element *E = custom_monitors.front(); E; E = E->next()) {
+		r_names->push_back(E->key());
+	}
+	custom_monitors_mutex->unlock();
+}
+
+Array Performance::_get_custom_monitor_names() const {
+
+	List<StringName> names;
+	get_custom_monitor_names(&names);
+
+	Array ret;
+	for (List<StringName>::Element *E = names.front(); E; E = E->next()) {
+		ret.push_back(E->get());
+	}
+	return ret;
+}
+
+void Performance::start_trace_capture(int p_frames) {
+
+#ifdef DEBUG_ENABLED
+	Profiler::start_capture(p_frames);
+#else
+	WARN_PRINT("Trace capture is only available in debug builds.");
+#endif
+}
+
+void Performance::stop_trace_capture() {
+
+	Profiler::stop_capture();
+}
+
+bool Performance::is_capturing_trace() const {
+
+	return Profiler::is_capturing();
+}
+
+Error Performance::save_trace(const String &p_path) {
+
+	return Profiler::save_chrome_trace(p_path);
+}
+
 Performance::Performance() {
 
 	_process_time = 0;
 	_fixed_process_time = 0;
+	custom_monitors_mutex = Mutex::create();
 	singleton = this;
 }
+
+Performance::~Performance() {
+
+	memdelete(custom_monitors_mutex);
+}
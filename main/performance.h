@@ -31,7 +31,9 @@
 #ifndef PERFORMANCE_H
 #define PERFORMANCE_H
 
+#include "map.h"
 #include "object.h"
+#include "os/mutex.h"
 
 #define PERF_WARN_OFFLINE_FUNCTION
 #define PERF_WARN_PROCESS_SYNC
@@ -46,6 +48,22 @@ class Performance : public Object {
 	float _process_time;
 	float _fixed_process_time;
 
+public:
+	typedef float (*CustomMonitorFunc)(void *p_userdata);
+
+private:
+	struct CustomMonitor {
+		ObjectID target;
+		StringName method;
+		CustomMonitorFunc func;
+		void *userdata;
+	};
+
+	Map<StringName, CustomMonitor> custom_monitors;
+	Mutex *custom_monitors_mutex;
+
+	Array _get_custom_monitor_names() const;
+
 public:
 	enum Monitor {
 
@@ -77,6 +95,9 @@ public:
 		PHYSICS_3D_COLLISION_PAIRS,
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
+		RENDER_2D_COMMAND_ALLOCATIONS_IN_FRAME,
+		RENDER_TEXTURE_MEM_EVICTED,
+		RENDER_TEXTURES_RESTREAMED_IN_FRAME,
 		MONITOR_MAX
 	};
 
@@ -91,12 +112,25 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	void add_custom_monitor(const StringName &p_id, Object *p_target, const StringName &p_method);
+	void add_custom_monitor_func(const StringName &p_id, CustomMonitorFunc p_func, void *p_userdata);
+	void remove_custom_monitor(const StringName &p_id);
+	bool has_custom_monitor(const StringName &p_id) const;
+	float get_custom_monitor(const StringName &p_id) const;
+	void get_custom_monitor_names(List<StringName> *r_names) const;
+
+	void start_trace_capture(int p_frames);
+	void stop_trace_capture();
+	bool is_capturing_trace() const;
+	Error save_trace(const String &p_path);
+
 	void set_process_time(float p_pt);
 	void set_fixed_process_time(float p_pt);
 
 	static Performance *get_singleton() { return singleton; }
 
 	Performance();
+	~Performance();
 };
 
 VARIANT_ENUM_CAST(Performance::Monitor);
@@ -0,0 +1,373 @@
+/*************************************************************************/
+/*  test_bench.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_bench.h"
+
+#include "message_queue.h"
+#include "modules/quark_api/include/quark_api.h"
+#include "os/file_access.h"
+#include "os/memory.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/gui/box_container.h"
+#include "scene/gui/button.h"
+#include "scene/gui/item_list.h"
+#include "scene/gui/label.h"
+#include "scene/gui/line_edit.h"
+#include "scene/gui/rich_text_label.h"
+#include "scene/gui/text_edit.h"
+#include "scene/gui/tree.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+#include "version.h"
+
+namespace TestBench {
+
+enum {
+	FORM_ROWS = 2500, // a row is an HBoxContainer with three controls, 10k controls in total
+	LIST_ITEMS = 10000,
+	SCROLL_STEPS = 200,
+	RESIZE_STEPS = 50,
+	THEME_SWITCHES = 20,
+	QUARK_CALLS = 10000,
+};
+
+static void _quark_notify(char *p_event) {
+}
+
+class BenchMainLoop : public SceneTree {
+
+	struct Result {
+		String name;
+		int iterations;
+		uint64_t usec;
+		uint64_t allocations;
+	};
+
+	String filter;
+	String output_path;
+	Vector<Result> results;
+
+	Control *stage;
+
+	uint64_t begin_usec;
+	uint64_t begin_allocations;
+
+	bool _should_run(const String &p_name) const {
+
+		return filter == "" || p_name.find(filter) != -1;
+	}
+
+	void _begin() {
+
+		begin_allocations = Memory::get_alloc_total();
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+	}
+
+	void _end(const String &p_name, int p_iterations) {
+
+		Result r;
+		r.usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+		r.allocations = Memory::get_alloc_total() - begin_allocations;
+		r.name = p_name;
+		r.iterations = p_iterations;
+		results.push_back(r);
+
+		print_line(p_name + ": " + rtos(r.usec / 1000.0) + " msec, " + itos(r.allocations) + " allocations");
+	}
+
+	// Runs what a frame would run after input: deferred sorting, resizing and NOTIFICATION_DRAW.
+	void _settle() {
+
+		MessageQueue::get_singleton()->flush();
+	}
+
+	void _discard(Control *p_control) {
+
+		stage->remove_child(p_control);
+		memdelete(p_control);
+		_settle();
+	}
+
+	VBoxContainer *_make_form() {
+
+		VBoxContainer *form = memnew(VBoxContainer);
+		for (int i = 0; i < FORM_ROWS; i++) {
+
+			HBoxContainer *row = memnew(HBoxContainer);
+
+			Label *label = memnew(Label);
+			label->set_text("Field " + itos(i));
+			row->add_child(label);
+
+			LineEdit *line_edit = memnew(LineEdit);
+			line_edit->set_text("Value " + itos(i));
+			line_edit->set_h_size_flags(Control::SIZE_EXPAND_FILL);
+			row->add_child(line_edit);
+
+			Button *button = memnew(Button);
+			button->set_text("...");
+			row->add_child(button);
+
+			form->add_child(row);
+		}
+		return form;
+	}
+
+	void _bench_form() {
+
+		if (_should_run("form_build")) {
+
+			_begin();
+			VBoxContainer *form = _make_form();
+			stage->add_child(form);
+			_settle();
+			_end("form_build", FORM_ROWS * 4);
+			_discard(form);
+		}
+
+		if (_should_run("form_resize")) {
+
+			VBoxContainer *form = _make_form();
+			stage->add_child(form);
+			_settle();
+
+			_begin();
+			for (int i = 0; i < RESIZE_STEPS; i++) {
+				form->set_size(Size2(640 + (i % 2) * 384, 480));
+				_settle();
+			}
+			_end("form_resize", RESIZE_STEPS);
+			_discard(form);
+		}
+
+		if (_should_run("theme_switch")) {
+
+			VBoxContainer *form = _make_form();
+			stage->add_child(form);
+			_settle();
+
+			Ref<Theme> themes[2];
+			for (int i = 0; i < 2; i++) {
+				themes[i].instance();
+				themes[i]->copy_default_theme();
+			}
+			themes[1]->set_color("font_color", "Label", Color(1, 0.5, 0.5));
+
+			_begin();
+			for (int i = 0; i < THEME_SWITCHES; i++) {
+				form->set_theme(themes[i % 2]);
+				_settle();
+			}
+			_end("theme_switch", THEME_SWITCHES);
+			_discard(form);
+		}
+	}
+
+	void _bench_scrolling() {
+
+		if (_should_run("tree_scroll")) {
+
+			Tree *tree = memnew(Tree);
+			tree->set_size(Size2(640, 480));
+			stage->add_child(tree);
+
+			Vector<TreeItem *> items;
+			TreeItem *root = tree->create_item();
+			for (int i = 0; i < LIST_ITEMS; i++) {
+				TreeItem *item = tree->create_item(root);
+				item->set_text(0, "Item " + itos(i));
+				items.push_back(item);
+			}
+			_settle();
+
+			_begin();
+			for (int i = 0; i < SCROLL_STEPS; i++) {
+				tree->scroll_to_item(items[(i * 997) % LIST_ITEMS]);
+				_settle();
+			}
+			_end("tree_scroll", SCROLL_STEPS);
+			_discard(tree);
+		}
+
+		if (_should_run("item_list_scroll")) {
+
+			ItemList *item_list = memnew(ItemList);
+			item_list->set_size(Size2(640, 480));
+			stage->add_child(item_list);
+
+			for (int i = 0; i < LIST_ITEMS; i++) {
+				item_list->add_item("Item " + itos(i));
+			}
+			_settle();
+
+			_begin();
+			for (int i = 0; i < SCROLL_STEPS; i++) {
+				item_list->select((i * 997) % LIST_ITEMS);
+				item_list->ensure_current_is_visible();
+				_settle();
+			}
+			_end("item_list_scroll", SCROLL_STEPS);
+			_discard(item_list);
+		}
+
+		if (_should_run("text_edit_scroll")) {
+
+			TextEdit *text_edit = memnew(TextEdit);
+			text_edit->set_size(Size2(640, 480));
+			stage->add_child(text_edit);
+
+			String text;
+			for (int i = 0; i < LIST_ITEMS; i++) {
+				text += "Line " + itos(i) + ": the quick brown fox jumps over the lazy dog\n";
+			}
+			text_edit->set_text(text);
+			_settle();
+
+			_begin();
+			for (int i = 0; i < SCROLL_STEPS; i++) {
+				text_edit->set_v_scroll((i * 997) % LIST_ITEMS);
+				_settle();
+			}
+			_end("text_edit_scroll", SCROLL_STEPS);
+			_discard(text_edit);
+		}
+
+		if (_should_run("rich_text_scroll")) {
+
+			RichTextLabel *rich_text = memnew(RichTextLabel);
+			rich_text->set_size(Size2(640, 480));
+			stage->add_child(rich_text);
+
+			for (int i = 0; i < LIST_ITEMS; i++) {
+				rich_text->push_color(Color(1, 1, (i % 10) / 10.0));
+				rich_text->add_text("Paragraph " + itos(i) + ": the quick brown fox jumps over the lazy dog");
+				rich_text->pop();
+				rich_text->add_newline();
+			}
+			_settle();
+
+			_begin();
+			for (int i = 0; i < SCROLL_STEPS; i++) {
+				rich_text->scroll_to_line((i * 997) % LIST_ITEMS);
+				_settle();
+			}
+			_end("rich_text_scroll", SCROLL_STEPS);
+			_discard(rich_text);
+		}
+	}
+
+	void _bench_quark_api() {
+
+		if (!_should_run("quark_api_call"))
+			return;
+
+		Button *button = memnew(Button);
+		stage->add_child(button);
+
+		uint32_t user_id = quark_api_init(&_quark_notify);
+
+		char command[256];
+		char response[512];
+		snprintf(command, sizeof(command), "(call %i \"set_text\" \"Called From Quark\")", (int)button->get_instance_id());
+
+		_begin();
+		for (int i = 0; i < QUARK_CALLS; i++) {
+			quark_api_call(user_id, command, response, sizeof(response));
+		}
+		_end("quark_api_call", QUARK_CALLS);
+		_discard(button);
+	}
+
+	String _to_json() const {
+
+		String json = "{\n\t\"version\": \"" + String(VERSION_FULL_NAME).json_escape() + "\",\n\t\"results\": [";
+		for (int i = 0; i < results.size(); i++) {
+
+			const Result &r = results[i];
+			json += String(i ? "," : "") + "\n\t\t{ \"name\": \"" + r.name + "\", \"iterations\": " + itos(r.iterations);
+			json += ", \"usec\": " + itos(r.usec) + ", \"usec_per_iteration\": " + rtos(double(r.usec) / MAX(r.iterations, 1));
+			json += ", \"allocations\": " + itos(r.allocations) + " }";
+		}
+		json += "\n\t]\n}\n";
+		return json;
+	}
+
+public:
+	virtual void init() {
+
+		SceneTree::init();
+
+		stage = memnew(Control);
+		stage->set_size(Size2(1024, 768));
+		get_root()->add_child(stage);
+
+		_bench_form();
+		_bench_scrolling();
+		_bench_quark_api();
+
+		String json = _to_json();
+		print_line(json);
+
+		if (output_path != "") {
+			FileAccess *f = FileAccess::open(output_path, FileAccess::WRITE);
+			if (f) {
+				f->store_string(json);
+				memdelete(f);
+			} else {
+				ERR_PRINTS("Can't write benchmark results to: " + output_path);
+			}
+		}
+
+		quit();
+	}
+
+	BenchMainLoop() {
+
+		stage = NULL;
+		begin_usec = 0;
+		begin_allocations = 0;
+
+		List<String> args = OS::get_singleton()->get_cmdline_args();
+		for (List<String>::Element *E = args.front(); E && E->next(); E = E->next()) {
+			if (E->get() == "--bench-filter") {
+				filter = E->next()->get();
+			} else if (E->get() == "--bench-output") {
+				output_path = E->next()->get();
+			}
+		}
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(BenchMainLoop);
+}
+} // namespace TestBench
@@ -0,0 +1,199 @@
+/*************************************************************************/
+/*  test_class_db.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_class_db.h"
+
+#include "class_db.h"
+#include "os/os.h"
+#include "scene/gui/popup_menu.h"
+#include "scene/gui/tree.h"
+
+namespace TestClassDB {
+
+#define ITERATIONS 200000
+
+static uint64_t _bench_call(Object *p_object, const StringName &p_method) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		p_object->call(p_method);
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static uint64_t _bench_set(Object *p_object, const StringName &p_property, const Variant &p_value) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		p_object->set(p_property, p_value);
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static void _bench_object(Object *p_object) {
+
+	// methods and properties declared a few levels up the inheritance chain
+	StringName node_method = "get_name";
+	StringName control_method = "get_minimum_size";
+	StringName control_property = "mouse_filter";
+	StringName canvas_item_property = "self_modulate";
+
+	bool was_sealed = ClassDB::is_sealed();
+
+	for (int pass = 0; pass < 2; pass++) {
+
+		if (pass == 0)
+			ClassDB::unseal();
+		else
+			ClassDB::seal();
+
+		OS::get_singleton()->print("%s (%s):\n", String(p_object->get_class_name()).utf8().get_data(), pass == 0 ? "inheritance walk" : "dispatch tables");
+		OS::get_singleton()->print("\tcall %s: %d usec\n", String(node_method).utf8().get_data(), (int)_bench_call(p_object, node_method));
+		OS::get_singleton()->print("\tcall %s: %d usec\n", String(control_method).utf8().get_data(), (int)_bench_call(p_object, control_method));
+		OS::get_singleton()->print("\tset %s: %d usec\n", String(control_property).utf8().get_data(), (int)_bench_set(p_object, control_property, Control::MOUSE_FILTER_PASS));
+		OS::get_singleton()->print("\tset %s: %d usec\n", String(canvas_item_property).utf8().get_data(), (int)_bench_set(p_object, canvas_item_property, Color(1, 1, 1, 0.5)));
+	}
+
+	if (!was_sealed)
+		ClassDB::unseal();
+}
+
+static void _collect_names(const StringName &p_class, Set<StringName> *r_methods, Set<StringName> *r_properties) {
+
+	for (ClassDB::ClassInfo *check = ClassDB::classes.getptr(p_class); check; check = check->inherits_ptr) {
+
+		const StringName *K = NULL;
+		while ((K = check->method_map.next(K)))
+			r_methods->insert(*K);
+
+		K = NULL;
+		while ((K = check->property_setget.next(K)))
+			r_properties->insert(*K);
+
+		K = NULL;
+		while ((K = check->constant_map.next(K)))
+			r_properties->insert(*K);
+	}
+
+	// and something nobody declares
+	r_methods->insert("__no_such_method__");
+	r_properties->insert("__no_such_property__");
+}
+
+struct Resolved {
+
+	MethodBind *method;
+	bool found;
+	ClassDB::PropertyLookup lookup;
+};
+
+static void _resolve_all(const List<StringName> &p_classes, Vector<Resolved> *r_resolved) {
+
+	for (const List<StringName>::Element *E = p_classes.front(); E; E = E->next()) {
+
+		Set<StringName> methods;
+		Set<StringName> properties;
+		_collect_names(E->get(), &methods, &properties);
+
+		for (Set<StringName>::Element *M = methods.front(); M; M = M->next()) {
+
+			Resolved r;
+			r.method = ClassDB::get_method(E->get(), M->get());
+			r.found = r.method != NULL;
+			r_resolved->push_back(r);
+		}
+
+		for (Set<StringName>::Element *P = properties.front(); P; P = P->next()) {
+
+			Resolved r;
+			r.method = NULL;
+			r.found = ClassDB::_lookup_property(E->get(), P->get(), r.lookup);
+			r_resolved->push_back(r);
+		}
+	}
+}
+
+static bool _check_dispatch_tables() {
+
+	bool was_sealed = ClassDB::is_sealed();
+
+	List<StringName> classes;
+	ClassDB::get_class_list(&classes);
+
+	Vector<Resolved> walked;
+	Vector<Resolved> flat;
+
+	ClassDB::unseal();
+	_resolve_all(classes, &walked);
+	ClassDB::seal();
+	_resolve_all(classes, &flat);
+
+	if (!was_sealed)
+		ClassDB::unseal();
+
+	if (walked.size() != flat.size()) {
+		OS::get_singleton()->print("\tFAIL: resolved %d names walking, %d flat\n", walked.size(), flat.size());
+		return false;
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < walked.size(); i++) {
+
+		const Resolved &a = walked[i];
+		const Resolved &b = flat[i];
+
+		if (a.found != b.found || a.method != b.method || a.lookup.setget != b.lookup.setget || a.lookup.constant != b.lookup.constant || a.lookup.constant_first != b.lookup.constant_first)
+			mismatches++;
+	}
+
+	OS::get_singleton()->print("\t%d classes, %d lookups, %d mismatches: %s\n", classes.size(), walked.size(), mismatches, mismatches ? "FAIL" : "PASS");
+
+	return mismatches == 0;
+}
+
+MainLoop *test() {
+
+	OS::get_singleton()->print("\n\nDispatch tables against the inheritance walk\n");
+
+	_check_dispatch_tables();
+
+	OS::get_singleton()->print("\n\nObject dispatch, %d iterations per measurement\n", ITERATIONS);
+
+	Tree *tree = memnew(Tree);
+	_bench_object(tree);
+	memdelete(tree);
+
+	PopupMenu *popup = memnew(PopupMenu);
+	_bench_object(popup);
+	memdelete(popup);
+
+	return NULL;
+}
+} // namespace TestClassDB
@@ -33,6 +33,8 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_bench.h"
+#include "test_class_db.h"
 #include "test_gui.h"
 #include "test_image.h"
 #include "test_io.h"
@@ -55,6 +57,8 @@ const char **tests_get_names() {
 		"io",
 		"shaderlang",
 		"oa_hash_map",
+		"class_db",
+		"bench",
 		NULL
 	};
 
@@ -83,6 +87,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOAHashMap::test();
 	}
 
+	if (p_test == "class_db") {
+
+		return TestClassDB::test();
+	}
+
 	if (p_test == "gui") {
 
 		return TestGUI::test();
@@ -108,6 +117,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOrderedHashMap::test();
 	}
 
+	if (p_test == "bench") {
+
+		return TestBench::test();
+	}
+
 	return NULL;
 }
 
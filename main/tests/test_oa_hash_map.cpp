@@ -32,6 +32,7 @@
 
 #include "core/os/os.h"
 
+#include "core/hash_map.h"
 #include "core/oa_hash_map.h"
 
 namespace TestOAHashMap {
@@ -92,6 +93,98 @@ MainLoop *test() {
 		}
 	}
 
+	// erase with backward shift, copies and key iteration
+	{
+		OAHashMap<int, int> map;
+
+		for (int i = 0; i < 1000; i++) {
+			map.set(i, i);
+		}
+		for (int i = 0; i < 1000; i += 3) {
+			map.erase(i);
+		}
+
+		OAHashMap<int, int> copy = map;
+		bool ok = copy.get_num_elements() == map.get_num_elements();
+		for (int i = 0; i < 1000; i++) {
+			const int *v = copy.getptr(i);
+			ok = ok && ((i % 3 == 0) ? v == NULL : (v != NULL && *v == i));
+		}
+
+		uint32_t visited = 0;
+		for (const int *k = map.next(NULL); k; k = map.next(k)) {
+			visited++;
+		}
+		ok = ok && visited == map.get_num_elements();
+
+		OS::get_singleton()->print("erase/copy/next: %s\n", ok ? "OK" : "FAILED");
+	}
+
+	// chained HashMap vs. open addressing
+	{
+		const int count = 100000;
+		const int lookups = 5;
+
+		Vector<String> names;
+		names.resize(count);
+		for (int i = 0; i < count; i++) {
+			names[i] = "item_" + itos(i * 13);
+		}
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		HashMap<int, int> hm;
+		for (int i = 0; i < count; i++) {
+			hm[i * 13] = i;
+		}
+		int64_t sum = 0;
+		for (int l = 0; l < lookups; l++) {
+			for (int i = 0; i < count; i++) {
+				sum += *hm.getptr(i * 13);
+			}
+		}
+		uint64_t hm_int = OS::get_singleton()->get_ticks_usec() - t;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		OAHashMap<int, int> oa;
+		for (int i = 0; i < count; i++) {
+			oa.set(i * 13, i);
+		}
+		for (int l = 0; l < lookups; l++) {
+			for (int i = 0; i < count; i++) {
+				sum -= *oa.getptr(i * 13);
+			}
+		}
+		uint64_t oa_int = OS::get_singleton()->get_ticks_usec() - t;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		HashMap<String, int> hms;
+		for (int i = 0; i < count; i++) {
+			hms[names[i]] = i;
+		}
+		for (int l = 0; l < lookups; l++) {
+			for (int i = 0; i < count; i++) {
+				sum += *hms.getptr(names[i]);
+			}
+		}
+		uint64_t hm_str = OS::get_singleton()->get_ticks_usec() - t;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		OAHashMap<String, int> oas;
+		for (int i = 0; i < count; i++) {
+			oas.set(names[i], i);
+		}
+		for (int l = 0; l < lookups; l++) {
+			for (int i = 0; i < count; i++) {
+				sum -= *oas.getptr(names[i]);
+			}
+		}
+		uint64_t oa_str = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("int keys:    HashMap %d usec, OAHashMap %d usec\n", (int)hm_int, (int)oa_int);
+		OS::get_singleton()->print("String keys: HashMap %d usec, OAHashMap %d usec\n", (int)hm_str, (int)oa_str);
+		OS::get_singleton()->print("checksum %s\n", sum == 0 ? "OK" : "FAILED");
+	}
+
 	return NULL;
 }
 } // namespace TestOAHashMap
@@ -799,6 +799,74 @@ bool test_28() {
 	return state;
 }
 
+bool test_29() {
+
+	OS::get_singleton()->print("\n\nTest 29: UTF-8 conversion of large strings\n");
+
+	const int size = 4 * 1024 * 1024;
+	const int rounds = 8;
+
+	// "Godot" in Japanese, cut in at intervals into otherwise ASCII text
+	static const CharType mixed_chars[] = { 0x30B4, 0x30C9, 0x30FC };
+
+	String ascii;
+	String mixed;
+	ascii.resize(size + 1);
+	mixed.resize(size + 1);
+	for (int i = 0; i < size; i++) {
+		CharType c = 'a' + (i % 26);
+		ascii[i] = c;
+		mixed[i] = (i % 64) < 3 ? mixed_chars[i % 64] : c;
+	}
+	ascii[size] = 0;
+	mixed[size] = 0;
+
+	bool state = true;
+
+	const String *inputs[2] = { &ascii, &mixed };
+	const char *names[2] = { "ascii", "mixed" };
+
+	for (int i = 0; i < 2; i++) {
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		CharString utf8;
+		for (int j = 0; j < rounds; j++) {
+			utf8 = inputs[i]->utf8();
+		}
+		uint64_t encode_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		String decoded;
+		for (int j = 0; j < rounds; j++) {
+			decoded.parse_utf8(utf8.get_data(), utf8.length());
+		}
+		uint64_t decode_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+		bool ok = decoded == *inputs[i];
+		state = state && ok;
+
+		float mb = float(size) * rounds / (1024 * 1024);
+		OS::get_singleton()->print("\t%s: utf8() %.1f MB/s, parse_utf8() %.1f MB/s, round trip %s\n", names[i], mb / (encode_usec / 1000000.0), mb / (decode_usec / 1000000.0), ok ? "OK" : "FAIL");
+	}
+
+	// ASCII runs of every length around the vector width, next to multi-byte sequences
+	for (int i = 0; state && i < 40; i++) {
+
+		String s;
+		for (int j = 0; j < i; j++) {
+			s += String::chr('A' + j % 26);
+		}
+		s += String::chr(0xE9);
+		s += s;
+
+		String decoded;
+		decoded.parse_utf8(s.utf8().get_data());
+		state = decoded == s;
+	}
+
+	return state;
+}
+
 typedef bool (*TestFunc)(void);
 
 TestFunc test_funcs[] = {
@@ -831,6 +899,7 @@ TestFunc test_funcs[] = {
 	test_26,
 	test_27,
 	test_28,
+	test_29,
 	0
 
 };
@@ -282,6 +282,11 @@ void QAPI quark_print_error(const char *p_description, const char *p_function, c
 void QAPI quark_print_warning(const char *p_description, const char *p_function, const char *p_file, int p_line);
 void QAPI quark_print(const quark_string *p_message);
 
+//custom monitors shown next to the built-in Performance ones
+typedef quark_real (*quark_performance_monitor_fn)(void *p_user_data);
+void QAPI quark_performance_add_custom_monitor(const char *p_id, quark_performance_monitor_fn p_func, void *p_user_data);
+void QAPI quark_performance_remove_custom_monitor(const char *p_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,7 @@
 #include "os/os.h"
 
 #include "scene/main/scene_tree.h"
+#include "scene/scene_string_names.h"
 
 #include <stdlib.h>
 
@@ -49,6 +50,101 @@
 #include "api_generator.h"
 #endif
 
+void NativeScriptDesc::build_dispatch() {
+
+	// the tables of a class are only valid while those of its bases are
+	if (base_data && !base_data->dispatch_valid) {
+		base_data->build_dispatch();
+	}
+
+	method_table.clear();
+	property_table.clear();
+	set_method = NULL;
+	set_method_depth = -1;
+	get_method = NULL;
+	get_method_depth = -1;
+
+	int depth = 0;
+	for (NativeScriptDesc *script_data = this; script_data; script_data = script_data->base_data, depth++) {
+
+		for (Map<StringName, Method>::Element *M = script_data->methods.front(); M; M = M->next()) {
+			method_table[M->key()].push_back(&M->get());
+		}
+
+		for (OrderedHashMap<StringName, Property>::Element P = script_data->properties.front(); P; P = P.next()) {
+			if (property_table.has(P.key()))
+				continue;
+
+			PropertySlot slot;
+			slot.property = &P.get();
+			slot.depth = depth;
+			property_table[P.key()] = slot;
+		}
+
+		if (!set_method) {
+			Map<StringName, Method>::Element *E = script_data->methods.find("_set");
+			if (E) {
+				set_method = &E->get();
+				set_method_depth = depth;
+			}
+		}
+
+		if (!get_method) {
+			Map<StringName, Method>::Element *E = script_data->methods.find("_get");
+			if (E) {
+				get_method = &E->get();
+				get_method_depth = depth;
+			}
+		}
+	}
+
+	const Vector<const Method *> *chain = method_table.getptr("_notification");
+	notification_methods = chain ? *chain : Vector<const Method *>();
+
+	chain = method_table.getptr("_get_property_list");
+	get_property_list_methods = chain ? *chain : Vector<const Method *>();
+
+	chain = method_table.getptr("_refcount_incremented");
+	refcount_incremented_method = chain ? (*chain)[0] : NULL;
+
+	chain = method_table.getptr("_refcount_decremented");
+	refcount_decremented_method = chain ? (*chain)[0] : NULL;
+
+	const SceneStringNames *sn = SceneStringNames::get_singleton();
+	virtual_slots[VIRTUAL_PROCESS] = method_table.getptr(sn->_process);
+	virtual_slots[VIRTUAL_FIXED_PROCESS] = method_table.getptr(sn->_fixed_process);
+	virtual_slots[VIRTUAL_INPUT] = method_table.getptr(sn->_input);
+	virtual_slots[VIRTUAL_UNHANDLED_INPUT] = method_table.getptr(sn->_unhandled_input);
+	virtual_slots[VIRTUAL_UNHANDLED_KEY_INPUT] = method_table.getptr(sn->_unhandled_key_input);
+	virtual_slots[VIRTUAL_GUI_INPUT] = method_table.getptr(sn->_gui_input);
+	virtual_slots[VIRTUAL_DRAW] = method_table.getptr(sn->_draw);
+
+	dispatch_valid = true;
+}
+
+const Vector<const NativeScriptDesc::Method *> *NativeScriptDesc::get_method_chain(const StringName &p_method) const {
+
+	// the engine passes these very StringNames, so comparing them is a pointer compare
+	const SceneStringNames *sn = SceneStringNames::get_singleton();
+
+	if (p_method == sn->_process)
+		return virtual_slots[VIRTUAL_PROCESS];
+	if (p_method == sn->_fixed_process)
+		return virtual_slots[VIRTUAL_FIXED_PROCESS];
+	if (p_method == sn->_input)
+		return virtual_slots[VIRTUAL_INPUT];
+	if (p_method == sn->_unhandled_input)
+		return virtual_slots[VIRTUAL_UNHANDLED_INPUT];
+	if (p_method == sn->_unhandled_key_input)
+		return virtual_slots[VIRTUAL_UNHANDLED_KEY_INPUT];
+	if (p_method == sn->_gui_input)
+		return virtual_slots[VIRTUAL_GUI_INPUT];
+	if (p_method == sn->_draw)
+		return virtual_slots[VIRTUAL_DRAW];
+
+	return method_table.getptr(p_method);
+}
+
 //
 //
 // Script stuff
@@ -102,6 +198,7 @@ void NativeScript::_placeholder_erased(PlaceHolderScriptInstance *p_placeholder)
 
 void NativeScript::set_class_name(String p_class_name) {
 	class_name = p_class_name;
+	desc_cache_version = 0;
 }
 
 String NativeScript::get_class_name() const {
@@ -115,6 +212,7 @@ void NativeScript::set_library(Ref<QNativeLibrary> p_library) {
 	}
 	library = p_library;
 	lib_path = library->get_current_library_path();
+	desc_cache_version = 0;
 
 #ifndef NO_THREADS
 	if (Thread::get_caller_id() != Thread::get_main_id()) {
@@ -209,13 +307,10 @@ Error NativeScript::reload(bool p_keep_state) {
 bool NativeScript::has_method(const StringName &p_method) const {
 	NativeScriptDesc *script_data = get_script_desc();
 
-	while (script_data) {
-		if (script_data->methods.has(p_method))
-			return true;
+	if (!script_data)
+		return false;
 
-		script_data = script_data->base_data;
-	}
-	return false;
+	return script_data->get_method_chain(p_method) != NULL;
 }
 
 MethodInfo NativeScript::get_method_info(const StringName &p_method) const {
@@ -477,6 +572,8 @@ NativeScript::NativeScript() {
 	library = Ref<QNative>();
 	lib_path = "";
 	class_name = "";
+	desc_cache = NULL;
+	desc_cache_version = 0;
 #ifndef NO_THREADS
 	owners_lock = Mutex::create();
 #endif
@@ -498,84 +595,73 @@ NativeScript::~NativeScript() {
 
 #define GET_SCRIPT_DESC() script->get_script_desc()
 
-void NativeScriptInstance::_ml_call_reversed(NativeScriptDesc *script_data, const StringName &p_method, const Variant **p_args, int p_argcount) {
-	if (script_data->base_data) {
-		_ml_call_reversed(script_data->base_data, p_method, p_args, p_argcount);
-	}
-
-	Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
-	if (E) {
-		quark_variant res = E->get().method.method((quark_object *)owner, E->get().method.method_data, userdata, p_argcount, (quark_variant **)p_args);
-		quark_variant_destroy(&res);
-	}
-}
-
 bool NativeScriptInstance::set(const StringName &p_name, const Variant &p_value) {
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
-		OrderedHashMap<StringName, NativeScriptDesc::Property>::Element P = script_data->properties.find(p_name);
-		if (P) {
-			P.get().setter.set_func((quark_object *)owner,
-					P.get().setter.method_data,
-					userdata,
-					(quark_variant *)&p_value);
-			return true;
-		}
+	if (!script_data)
+		return false;
 
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find("_set");
-		if (E) {
-			Variant name = p_name;
-			const Variant *args[2] = { &name, &p_value };
-
-			E->get().method.method((quark_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					2,
-					(quark_variant **)args);
-			return true;
-		}
+	// a property wins over a _set declared in the same class or further up
+	NativeScriptDesc::PropertySlot *P = script_data->property_table.getptr(p_name);
+	if (P && (!script_data->set_method || P->depth <= script_data->set_method_depth)) {
+		P->property->setter.set_func((quark_object *)owner,
+				P->property->setter.method_data,
+				userdata,
+				(quark_variant *)&p_value);
+		return true;
+	}
 
-		script_data = script_data->base_data;
+	const NativeScriptDesc::Method *set_method = script_data->set_method;
+	if (set_method) {
+		Variant name = p_name;
+		const Variant *args[2] = { &name, &p_value };
+
+		set_method->method.method((quark_object *)owner,
+				set_method->method.method_data,
+				userdata,
+				2,
+				(quark_variant **)args);
+		return true;
 	}
+
 	return false;
 }
 bool NativeScriptInstance::get(const StringName &p_name, Variant &r_ret) const {
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
-		OrderedHashMap<StringName, NativeScriptDesc::Property>::Element P = script_data->properties.find(p_name);
-		if (P) {
-			quark_variant value;
-			value = P.get().getter.get_func((quark_object *)owner,
-					P.get().getter.method_data,
-					userdata);
-			r_ret = *(Variant *)&value;
-			quark_variant_destroy(&value);
-			return true;
-		}
+	if (!script_data)
+		return false;
 
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find("_get");
-		if (E) {
-			Variant name = p_name;
-			const Variant *args[1] = { &name };
-
-			quark_variant result;
-			result = E->get().method.method((quark_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					1,
-					(quark_variant **)args);
-			r_ret = *(Variant *)&result;
-			quark_variant_destroy(&result);
-			if (r_ret.get_type() == Variant::NIL) {
-				return false;
-			}
-			return true;
-		}
+	NativeScriptDesc::PropertySlot *P = script_data->property_table.getptr(p_name);
+	if (P && (!script_data->get_method || P->depth <= script_data->get_method_depth)) {
+		quark_variant value;
+		value = P->property->getter.get_func((quark_object *)owner,
+				P->property->getter.method_data,
+				userdata);
+		r_ret = *(Variant *)&value;
+		quark_variant_destroy(&value);
+		return true;
+	}
 
-		script_data = script_data->base_data;
+	const NativeScriptDesc::Method *get_method = script_data->get_method;
+	if (get_method) {
+		Variant name = p_name;
+		const Variant *args[1] = { &name };
+
+		quark_variant result;
+		result = get_method->method.method((quark_object *)owner,
+				get_method->method.method_data,
+				userdata,
+				1,
+				(quark_variant **)args);
+		r_ret = *(Variant *)&result;
+		quark_variant_destroy(&result);
+		if (r_ret.get_type() == Variant::NIL) {
+			return false;
+		}
+		return true;
 	}
+
 	return false;
 }
 
@@ -584,57 +670,49 @@ void NativeScriptInstance::get_property_list(List<PropertyInfo> *p_properties) c
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
+	if (!script_data)
+		return;
 
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find("_get_property_list");
-		if (E) {
+	const Vector<const NativeScriptDesc::Method *> &methods = script_data->get_property_list_methods;
 
-			quark_variant result;
-			result = E->get().method.method((quark_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					0,
-					NULL);
-			Variant res = *(Variant *)&result;
-			quark_variant_destroy(&result);
-
-			if (res.get_type() != Variant::ARRAY) {
-				ERR_EXPLAIN("_get_property_list must return an array of dictionaries");
-				ERR_FAIL();
-			}
+	for (int m = 0; m < methods.size(); m++) {
 
-			Array arr = res;
-			for (int i = 0; i < arr.size(); i++) {
-				Dictionary d = arr[i];
+		Variant res = _call_method(methods[m], NULL, 0);
 
-				ERR_CONTINUE(!d.has("name"));
-				ERR_CONTINUE(!d.has("type"));
+		if (res.get_type() != Variant::ARRAY) {
+			ERR_EXPLAIN("_get_property_list must return an array of dictionaries");
+			ERR_FAIL();
+		}
 
-				PropertyInfo info;
+		Array arr = res;
+		for (int i = 0; i < arr.size(); i++) {
+			Dictionary d = arr[i];
 
-				info.type = Variant::Type(d["type"].operator int64_t());
-				ERR_CONTINUE(info.type < 0 || info.type >= Variant::VARIANT_MAX);
+			ERR_CONTINUE(!d.has("name"));
+			ERR_CONTINUE(!d.has("type"));
 
-				info.name = d["name"];
-				ERR_CONTINUE(info.name == "");
+			PropertyInfo info;
 
-				if (d.has("hint")) {
-					info.hint = PropertyHint(d["hint"].operator int64_t());
-				}
+			info.type = Variant::Type(d["type"].operator int64_t());
+			ERR_CONTINUE(info.type < 0 || info.type >= Variant::VARIANT_MAX);
 
-				if (d.has("hint_string")) {
-					info.hint_string = d["hint_string"];
-				}
+			info.name = d["name"];
+			ERR_CONTINUE(info.name == "");
 
-				if (d.has("usage")) {
-					info.usage = d["usage"];
-				}
+			if (d.has("hint")) {
+				info.hint = PropertyHint(d["hint"].operator int64_t());
+			}
 
-				p_properties->push_back(info);
+			if (d.has("hint_string")) {
+				info.hint_string = d["hint_string"];
 			}
-		}
 
-		script_data = script_data->base_data;
+			if (d.has("usage")) {
+				info.usage = d["usage"];
+			}
+
+			p_properties->push_back(info);
+		}
 	}
 	return;
 }
@@ -643,15 +721,13 @@ Variant::Type NativeScriptInstance::get_property_type(const StringName &p_name,
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
+	if (script_data) {
 
-		OrderedHashMap<StringName, NativeScriptDesc::Property>::Element P = script_data->properties.find(p_name);
+		const NativeScriptDesc::PropertySlot *P = script_data->property_table.getptr(p_name);
 		if (P) {
 			*r_is_valid = true;
-			return P.get().info.type;
+			return P->property->info.type;
 		}
-
-		script_data = script_data->base_data;
 	}
 	return Variant::NIL;
 }
@@ -664,26 +740,29 @@ bool NativeScriptInstance::has_method(const StringName &p_method) const {
 	return script->has_method(p_method);
 }
 
+Variant NativeScriptInstance::_call_method(const NativeScriptDesc::Method *p_method, const Variant **p_args, int p_argcount) const {
+
+	quark_variant result;
+	result = p_method->method.method((quark_object *)owner,
+			p_method->method.method_data,
+			userdata,
+			p_argcount,
+			(quark_variant **)p_args);
+	Variant res = *(Variant *)&result;
+	quark_variant_destroy(&result);
+	return res;
+}
+
 Variant NativeScriptInstance::call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
-		if (E) {
-			quark_variant result;
-			result = E->get().method.method((quark_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					p_argcount,
-					(quark_variant **)p_args);
-			Variant res = *(Variant *)&result;
-			quark_variant_destroy(&result);
+	if (script_data) {
+		const Vector<const NativeScriptDesc::Method *> *chain = script_data->get_method_chain(p_method);
+		if (chain) {
 			r_error.error = Variant::CallError::CALL_OK;
-			return res;
+			return _call_method((*chain)[0], p_args, p_argcount);
 		}
-
-		script_data = script_data->base_data;
 	}
 
 	r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
@@ -691,31 +770,36 @@ Variant NativeScriptInstance::call(const StringName &p_method, const Variant **p
 }
 
 void NativeScriptInstance::notification(int p_notification) {
+	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
+
+	if (!script_data || script_data->notification_methods.empty())
+		return;
+
 	Variant value = p_notification;
 	const Variant *args[1] = { &value };
-	call_multilevel("_notification", args, 1);
+
+	const Vector<const NativeScriptDesc::Method *> &methods = script_data->notification_methods;
+	for (int i = 0; i < methods.size(); i++) {
+		_call_method(methods[i], args, 1);
+	}
 }
 
 void NativeScriptInstance::refcount_incremented() {
-	Variant::CallError err;
-	call("_refcount_incremented", NULL, 0, err);
-	if (err.error != Variant::CallError::CALL_OK && err.error != Variant::CallError::CALL_ERROR_INVALID_METHOD) {
-		ERR_PRINT("Failed to invoke _refcount_incremented - should not happen");
+	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
+
+	if (script_data && script_data->refcount_incremented_method) {
+		_call_method(script_data->refcount_incremented_method, NULL, 0);
 	}
 }
 
 bool NativeScriptInstance::refcount_decremented() {
-	Variant::CallError err;
-	Variant ret = call("_refcount_decremented", NULL, 0, err);
-	if (err.error != Variant::CallError::CALL_OK && err.error != Variant::CallError::CALL_ERROR_INVALID_METHOD) {
-		ERR_PRINT("Failed to invoke _refcount_decremented - should not happen");
-		return true; // assume we can destroy the object
-	}
-	if (err.error == Variant::CallError::CALL_ERROR_INVALID_METHOD) {
+	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
+
+	if (!script_data || !script_data->refcount_decremented_method) {
 		// the method does not exist, default is true
 		return true;
 	}
-	return ret;
+	return _call_method(script_data->refcount_decremented_method, NULL, 0);
 }
 
 Ref<Script> NativeScriptInstance::get_script() const {
@@ -726,11 +810,11 @@ NativeScriptInstance::RPCMode NativeScriptInstance::get_rpc_mode(const StringNam
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
+	if (script_data) {
 
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
-		if (E) {
-			switch (E->get().rpc_mode) {
+		const Vector<const NativeScriptDesc::Method *> *chain = script_data->method_table.getptr(p_method);
+		if (chain) {
+			switch ((*chain)[0]->rpc_mode) {
 				case QUARK_METHOD_RPC_MODE_DISABLED:
 					return RPC_MODE_DISABLED;
 				case QUARK_METHOD_RPC_MODE_REMOTE:
@@ -745,8 +829,6 @@ NativeScriptInstance::RPCMode NativeScriptInstance::get_rpc_mode(const StringNam
 					return RPC_MODE_DISABLED;
 			}
 		}
-
-		script_data = script_data->base_data;
 	}
 
 	return RPC_MODE_DISABLED;
@@ -756,11 +838,11 @@ NativeScriptInstance::RPCMode NativeScriptInstance::get_rset_mode(const StringNa
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
+	if (script_data) {
 
-		OrderedHashMap<StringName, NativeScriptDesc::Property>::Element E = script_data->properties.find(p_variable);
+		const NativeScriptDesc::PropertySlot *E = script_data->property_table.getptr(p_variable);
 		if (E) {
-			switch (E.get().rset_mode) {
+			switch (E->property->rset_mode) {
 				case QUARK_METHOD_RPC_MODE_DISABLED:
 					return RPC_MODE_DISABLED;
 				case QUARK_METHOD_RPC_MODE_REMOTE:
@@ -775,8 +857,6 @@ NativeScriptInstance::RPCMode NativeScriptInstance::get_rset_mode(const StringNa
 					return RPC_MODE_DISABLED;
 			}
 		}
-
-		script_data = script_data->base_data;
 	}
 
 	return RPC_MODE_DISABLED;
@@ -789,25 +869,30 @@ ScriptLanguage *NativeScriptInstance::get_language() {
 void NativeScriptInstance::call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount) {
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
-		if (E) {
-			quark_variant res = E->get().method.method((quark_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					p_argcount,
-					(quark_variant **)p_args);
-			quark_variant_destroy(&res);
-		}
-		script_data = script_data->base_data;
+	if (!script_data)
+		return;
+
+	const Vector<const NativeScriptDesc::Method *> *chain = script_data->get_method_chain(p_method);
+	if (!chain)
+		return;
+
+	for (int i = 0; i < chain->size(); i++) {
+		_call_method((*chain)[i], p_args, p_argcount);
 	}
 }
 
 void NativeScriptInstance::call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount) {
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	if (script_data) {
-		_ml_call_reversed(script_data, p_method, p_args, p_argcount);
+	if (!script_data)
+		return;
+
+	const Vector<const NativeScriptDesc::Method *> *chain = script_data->get_method_chain(p_method);
+	if (!chain)
+		return;
+
+	for (int i = chain->size() - 1; i >= 0; i--) {
+		_call_method((*chain)[i], p_args, p_argcount);
 	}
 }
 
@@ -919,6 +1004,7 @@ void NativeScriptLanguage::_unload_stuff(bool p_reload) {
 
 NativeScriptLanguage::NativeScriptLanguage() {
 	NativeScriptLanguage::singleton = this;
+	classes_version = 1;
 #ifndef NO_THREADS
 	mutex = Mutex::create();
 #endif
@@ -933,6 +1019,7 @@ NativeScriptLanguage::~NativeScriptLanguage() {
 	}
 
 	NSL->library_classes.clear();
+	NSL->classes_version++;
 	NSL->library_qnatives.clear();
 	NSL->library_script_users.clear();
 
@@ -1207,6 +1294,7 @@ void NativeScriptLanguage::init_library(const Ref<QNativeLibrary> &lib) {
 		library_qnatives.insert(lib_path, qns);
 
 		library_classes.insert(lib_path, Map<StringName, NativeScriptDesc>());
+		classes_version++;
 
 		if (!library_script_users.has(lib_path))
 			library_script_users.insert(lib_path, Set<NativeScript *>());
@@ -1219,6 +1307,14 @@ void NativeScriptLanguage::init_library(const Ref<QNativeLibrary> &lib) {
 			ERR_PRINT(String("No " + _init_call_name + " in \"" + lib_path + "\" found").utf8().get_data());
 		} else {
 			((void (*)(quark_string *))proc_ptr)((quark_string *)&lib_path);
+
+			// everything is registered now, flatten the lookups up front
+			Map<StringName, NativeScriptDesc> &classes = library_classes[lib_path];
+			for (Map<StringName, NativeScriptDesc>::Element *C = classes.front(); C; C = C->next()) {
+				if (!C->get().dispatch_valid) {
+					C->get().build_dispatch();
+				}
+			}
 		}
 	} else {
 		// already initialized. Nice.
@@ -31,6 +31,7 @@
 #ifndef NATIVE_SCRIPT_H
 #define NATIVE_SCRIPT_H
 
+#include "core/hash_map.h"
 #include "core/resource.h"
 #include "core/script_language.h"
 #include "core/self_list.h"
@@ -84,6 +85,45 @@ struct NativeScriptDesc {
 
 	bool is_tool;
 
+	// Lookups flattened over the base_data chain so instances don't have to
+	// walk it (and hit a Map per level) on every call. Methods are listed
+	// closest class first, properties resolve to the closest declaration.
+	struct PropertySlot {
+		const Property *property;
+		int depth;
+	};
+
+	bool dispatch_valid;
+	HashMap<StringName, Vector<const Method *>, StringNameHasher> method_table;
+	HashMap<StringName, PropertySlot, StringNameHasher> property_table;
+	const Method *set_method;
+	int set_method_depth;
+	const Method *get_method;
+	int get_method_depth;
+	Vector<const Method *> notification_methods;
+	Vector<const Method *> get_property_list_methods;
+	const Method *refcount_incremented_method;
+	const Method *refcount_decremented_method;
+
+	// Virtuals the engine calls every frame or input event. Their chains
+	// are resolved into slots and matched by StringName identity, so these
+	// calls skip hashing the name.
+	enum EngineVirtual {
+		VIRTUAL_PROCESS,
+		VIRTUAL_FIXED_PROCESS,
+		VIRTUAL_INPUT,
+		VIRTUAL_UNHANDLED_INPUT,
+		VIRTUAL_UNHANDLED_KEY_INPUT,
+		VIRTUAL_GUI_INPUT,
+		VIRTUAL_DRAW,
+		VIRTUAL_MAX
+	};
+
+	const Vector<const Method *> *virtual_slots[VIRTUAL_MAX];
+
+	void build_dispatch();
+	const Vector<const Method *> *get_method_chain(const StringName &p_method) const;
+
 	inline NativeScriptDesc() :
 			methods(),
 			properties(),
@@ -91,9 +131,17 @@ struct NativeScriptDesc {
 			base(),
 			base_native_type(),
 			documentation(),
-			type_tag(NULL) {
+			type_tag(NULL),
+			dispatch_valid(false),
+			set_method(NULL),
+			set_method_depth(-1),
+			get_method(NULL),
+			get_method_depth(-1),
+			refcount_incremented_method(NULL),
+			refcount_decremented_method(NULL) {
 		zeromem(&create_func, sizeof(quark_instance_create_func));
 		zeromem(&destroy_func, sizeof(quark_instance_destroy_func));
+		zeromem(virtual_slots, sizeof(virtual_slots));
 	}
 };
 
@@ -117,6 +165,11 @@ class NativeScript : public Script {
 
 	String class_name;
 
+	// Resolved library_classes entry, valid while desc_cache_version
+	// matches NativeScriptLanguage::classes_version.
+	mutable NativeScriptDesc *desc_cache;
+	mutable uint64_t desc_cache_version;
+
 #ifndef NO_THREADS
 	Mutex *owners_lock;
 #endif
@@ -181,7 +234,7 @@ class NativeScriptInstance : public ScriptInstance {
 	Object *owner;
 	Ref<NativeScript> script;
 
-	void _ml_call_reversed(NativeScriptDesc *script_data, const StringName &p_method, const Variant **p_args, int p_argcount);
+	Variant _call_method(const NativeScriptDesc::Method *p_method, const Variant **p_args, int p_argcount) const;
 
 public:
 	void *userdata;
@@ -247,6 +300,9 @@ public:
 
 	Map<String, Set<NativeScript *> > library_script_users;
 
+	// Bumped whenever classes are added to or removed from library_classes.
+	uint64_t classes_version;
+
 	const StringName _init_call_type = "nativescript_init";
 	const StringName _init_call_name = "nativescript_init";
 
@@ -326,8 +382,15 @@ public:
 };
 
 inline NativeScriptDesc *NativeScript::get_script_desc() const {
-	Map<StringName, NativeScriptDesc>::Element *E = NativeScriptLanguage::singleton->library_classes[lib_path].find(class_name);
-	return E ? &E->get() : NULL;
+	if (desc_cache_version != NativeScriptLanguage::singleton->classes_version) {
+		Map<StringName, NativeScriptDesc>::Element *E = NativeScriptLanguage::singleton->library_classes[lib_path].find(class_name);
+		desc_cache = E ? &E->get() : NULL;
+		desc_cache_version = NativeScriptLanguage::singleton->classes_version;
+	}
+	if (desc_cache && !desc_cache->dispatch_valid) {
+		desc_cache->build_dispatch();
+	}
+	return desc_cache;
 }
 
 class NativeReloadNode : public Node {
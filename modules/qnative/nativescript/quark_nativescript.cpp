@@ -39,6 +39,17 @@
 
 #include "nativescript.h"
 
+// Methods and properties registered after the library was initialized must
+// show up in the flattened lookups of the class and the ones inheriting it.
+static void _invalidate_dispatch(Map<StringName, NativeScriptDesc> &p_classes, const NativeScriptDesc &p_desc) {
+	if (!p_desc.dispatch_valid)
+		return; // nothing built on top of it yet either
+
+	for (Map<StringName, NativeScriptDesc>::Element *C = p_classes.front(); C; C = C->next()) {
+		C->get().dispatch_valid = false;
+	}
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -73,6 +84,7 @@ void QAPI quark_register_class(void *p_qnative_handle, const char *p_name, const
 	}
 
 	classes->insert(p_name, desc);
+	NSL->classes_version++;
 }
 
 void QAPI quark_register_tool_class(void *p_qnative_handle, const char *p_name, const char *p_base, quark_instance_create_func p_create_func, quark_instance_destroy_func p_destroy_func) {
@@ -97,6 +109,7 @@ void QAPI quark_register_tool_class(void *p_qnative_handle, const char *p_name,
 	}
 
 	classes->insert(p_name, desc);
+	NSL->classes_version++;
 }
 
 void QAPI quark_register_method(void *p_qnative_handle, const char *p_name, const char *p_function_name, quark_method_attributes p_attr, quark_instance_method p_method) {
@@ -116,6 +129,7 @@ void QAPI quark_register_method(void *p_qnative_handle, const char *p_name, cons
 	method.info = MethodInfo(p_function_name);
 
 	E->get().methods.insert(p_function_name, method);
+	_invalidate_dispatch(NSL->library_classes[*s], E->get());
 }
 
 void QAPI quark_register_property(void *p_qnative_handle, const char *p_name, const char *p_path, quark_property_attributes *p_attr, quark_property_set_func p_set_func, quark_property_get_func p_get_func) {
@@ -141,6 +155,7 @@ void QAPI quark_register_property(void *p_qnative_handle, const char *p_name, co
 			(PropertyUsageFlags)p_attr->usage);
 
 	E->get().properties.insert(p_path, property);
+	_invalidate_dispatch(NSL->library_classes[*s], E->get());
 }
 
 void QAPI quark_register_signal(void *p_qnative_handle, const char *p_name, const quark_signal *p_signal) {
@@ -34,6 +34,7 @@
 #include "engine.h"
 #include "error_macros.h"
 #include "global_constants.h"
+#include "main/performance.h"
 #include "os/os.h"
 #include "variant.h"
 
@@ -140,6 +141,14 @@ void QAPI quark_print(const quark_string *p_message) {
 	print_line(*(String *)p_message);
 }
 
+void QAPI quark_performance_add_custom_monitor(const char *p_id, quark_performance_monitor_fn p_func, void *p_user_data) {
+	Performance::get_singleton()->add_custom_monitor_func(StringName(p_id), p_func, p_user_data);
+}
+
+void QAPI quark_performance_remove_custom_monitor(const char *p_id) {
+	Performance::get_singleton()->remove_custom_monitor(StringName(p_id));
+}
+
 void _qnative_report_version_mismatch(const quark_object *p_library, const char *p_ext, quark__api_version p_want, quark__api_version p_have) {
 	String message = "Error loading QNative file ";
 	QNativeLibrary *library = (QNativeLibrary *)p_library;
@@ -1421,7 +1421,7 @@ void OS_X11::handle_key_event(XKeyEvent *p_event, bool p_echo) {
 					k->set_shift(true);
 				}
 
-				input->parse_input_event(k);
+				input->accumulate_input_event(k);
 			}
 			return;
 		}
@@ -1566,7 +1566,7 @@ void OS_X11::handle_key_event(XKeyEvent *p_event, bool p_echo) {
 	}
 
 	//printf("key: %x\n",k->get_scancode());
-	input->parse_input_event(k);
+	input->accumulate_input_event(k);
 }
 
 struct Property {
@@ -1693,12 +1693,12 @@ void OS_X11::process_xevents() {
 							if (touch.state.has(index)) // Defensive
 								break;
 							touch.state[index] = pos;
-							input->parse_input_event(st);
+							input->accumulate_input_event(st);
 						} else {
 							if (!touch.state.has(index)) // Defensive
 								break;
 							touch.state.erase(index);
-							input->parse_input_event(st);
+							input->accumulate_input_event(st);
 						}
 					} break;
 
@@ -1716,7 +1716,7 @@ void OS_X11::process_xevents() {
 							sd->set_index(index);
 							sd->set_position(pos);
 							sd->set_relative(pos - curr_pos_elem->value());
-							input->parse_input_event(sd);
+							input->accumulate_input_event(sd);
 
 							curr_pos_elem->value() = pos;
 						}
@@ -1804,7 +1804,7 @@ void OS_X11::process_xevents() {
 					st.instance();
 					st->set_index(E->key());
 					st->set_position(E->get());
-					input->parse_input_event(st);
+					input->accumulate_input_event(st);
 				}
 				touch.state.clear();
 #endif
@@ -1857,7 +1857,7 @@ void OS_X11::process_xevents() {
 					}
 				}
 
-				input->parse_input_event(mb);
+				input->accumulate_input_event(mb);
 
 			} break;
 			case MotionNotify: {
@@ -1923,8 +1923,7 @@ void OS_X11::process_xevents() {
 
 				Point2i rel = pos - last_mouse_pos;
 
-				Ref<InputEventMouseMotion> mm;
-				mm.instance();
+				Ref<InputEventMouseMotion> mm = input->create_mouse_motion();
 
 				get_key_modifier_state(event.xmotion.state, mm);
 				mm->set_button_mask(get_mouse_button_state(event.xmotion.state));
@@ -1941,7 +1940,7 @@ void OS_X11::process_xevents() {
 				// this is so that the relative motion doesn't get messed up
 				// after we regain focus.
 				if (window_has_focus || !mouse_mode_grab)
-					input->parse_input_event(mm);
+					input->accumulate_input_event(mm);
 
 			} break;
 			case KeyPress:
@@ -2107,6 +2106,9 @@ void OS_X11::process_xevents() {
 		}
 	}
 
+	// Deliver whatever was merged while draining the X queue, once per frame.
+	input->flush_accumulated_events();
+
 	XFlush(x11_display);
 
 	if (do_mouse_warp) {
@@ -32,6 +32,7 @@
 #include "core/method_bind_ext.gen.inc"
 #include "message_queue.h"
 #include "os/input.h"
+#include "profiler.h"
 #include "scene/main/canvas_layer.h"
 #include "scene/main/viewport.h"
 #include "scene/resources/font.h"
@@ -319,6 +320,8 @@ Size2 CanvasItem::_edit_get_minimum_size() const {
 
 void CanvasItem::_update_callback() {
 
+	PROFILE_SCOPE("CanvasItem::_update_callback");
+
 	if (!is_inside_tree()) {
 		pending_update = false;
 		return;
@@ -339,6 +342,7 @@ void CanvasItem::_update_callback() {
 		}
 		drawing = false;
 	}
+	VisualServer::get_singleton()->canvas_item_end_draw(get_canvas_item());
 	//todo updating = false
 	pending_update = false; // don't change to false until finished drawing (avoid recursive update)
 }
@@ -524,7 +528,7 @@ void CanvasItem::update() {
 
 	pending_update = true;
 
-	MessageQueue::get_singleton()->push_call(this, "_update_callback");
+	MessageQueue::get_singleton()->push_call(this, &CanvasItem::_update_callback);
 }
 
 void CanvasItem::set_modulate(const Color &p_modulate) {
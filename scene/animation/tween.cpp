@@ -30,6 +30,7 @@
 
 #include "tween.h"
 #include "method_bind_ext.gen.inc"
+#include "scene/scene_string_names.h"
 
 void Tween::_add_pending_command(StringName p_key, const Variant &p_arg1, const Variant &p_arg2, const Variant &p_arg3, const Variant &p_arg4, const Variant &p_arg5, const Variant &p_arg6, const Variant &p_arg7, const Variant &p_arg8, const Variant &p_arg9, const Variant &p_arg10) {
 
@@ -465,6 +466,18 @@ Variant Tween::_run_equation(InterpolateData &p_data) {
 
 			result = r;
 		} break;
+		case Variant::RECT2: {
+			Rect2 i = initial_val;
+			Rect2 d = delta_val;
+			Rect2 r;
+
+			APPLY_EQUATION(position.x);
+			APPLY_EQUATION(position.y);
+			APPLY_EQUATION(size.x);
+			APPLY_EQUATION(size.y);
+
+			result = r;
+		} break;
 		default: {
 			result = initial_val;
 		} break;
@@ -474,6 +487,168 @@ Variant Tween::_run_equation(InterpolateData &p_data) {
 	return result;
 }
 
+bool Tween::_to_fast_lanes(const Variant &p_value, real_t *r_lanes) {
+
+	for (int i = 0; i < FAST_LANES; i++)
+		r_lanes[i] = 0;
+
+	switch (p_value.get_type()) {
+
+		case Variant::REAL: {
+			r_lanes[0] = p_value;
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			r_lanes[0] = v.x;
+			r_lanes[1] = v.y;
+		} break;
+		case Variant::COLOR: {
+			Color c = p_value;
+			r_lanes[0] = c.r;
+			r_lanes[1] = c.g;
+			r_lanes[2] = c.b;
+			r_lanes[3] = c.a;
+		} break;
+		case Variant::RECT2: {
+			Rect2 r = p_value;
+			r_lanes[0] = r.position.x;
+			r_lanes[1] = r.position.y;
+			r_lanes[2] = r.size.x;
+			r_lanes[3] = r.size.y;
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Variant Tween::_from_fast_lanes(Variant::Type p_type, const real_t *p_lanes) {
+
+	switch (p_type) {
+
+		case Variant::REAL:
+			return p_lanes[0];
+		case Variant::VECTOR2:
+			return Vector2(p_lanes[0], p_lanes[1]);
+		case Variant::COLOR:
+			return Color(p_lanes[0], p_lanes[1], p_lanes[2], p_lanes[3]);
+		case Variant::RECT2:
+			return Rect2(p_lanes[0], p_lanes[1], p_lanes[2], p_lanes[3]);
+		default:
+			return Variant();
+	}
+}
+
+int Tween::_alloc_fast_slot(Object *p_object, const Vector<StringName> &p_key, const Variant &p_initial_val, const Variant &p_delta_val) {
+
+#ifdef PTRCALL_ENABLED
+	// only a direct class property goes through the setter alone, scripts
+	// and subproperties need Object::set_indexed()
+	if (p_key.size() != 1 || p_object->get_script_instance())
+		return -1;
+
+	Variant::Type type = p_initial_val.get_type();
+	if (type != Variant::REAL && type != Variant::VECTOR2 && type != Variant::COLOR && type != Variant::RECT2)
+		return -1;
+
+	StringName class_name = p_object->get_class_name();
+	bool valid = false;
+	if (ClassDB::get_property_type(class_name, p_key[0], &valid) != type || !valid)
+		return -1;
+	if (ClassDB::get_property_index(class_name, p_key[0]) != -1)
+		return -1;
+
+	MethodBind *setter = ClassDB::get_method(class_name, ClassDB::get_property_setter(class_name, p_key[0]));
+	if (!setter || setter->get_argument_count() != 1)
+		return -1;
+
+	real_t initial[FAST_LANES];
+	real_t delta[FAST_LANES];
+	if (!_to_fast_lanes(p_initial_val, initial) || !_to_fast_lanes(p_delta_val, delta))
+		return -1;
+
+	int slot;
+	if (fast_free_slots.size()) {
+		slot = fast_free_slots[fast_free_slots.size() - 1];
+		fast_free_slots.resize(fast_free_slots.size() - 1);
+	} else {
+		slot = fast_slots.size();
+		fast_slots.resize(slot + 1);
+		fast_initial.resize((slot + 1) * FAST_LANES);
+		fast_delta.resize((slot + 1) * FAST_LANES);
+	}
+
+	FastSlot &fs = fast_slots[slot];
+	fs.setter = setter;
+	fs.type = type;
+
+	real_t *fi = fast_initial.ptrw() + slot * FAST_LANES;
+	real_t *fd = fast_delta.ptrw() + slot * FAST_LANES;
+	for (int i = 0; i < FAST_LANES; i++) {
+		fi[i] = initial[i];
+		fd[i] = delta[i];
+	}
+
+	return slot;
+#else
+	return -1;
+#endif
+}
+
+void Tween::_free_fast_slot(int p_slot) {
+
+	if (p_slot < 0)
+		return;
+
+	fast_slots[p_slot].setter = NULL;
+	fast_free_slots.push_back(p_slot);
+}
+
+void Tween::_eval_fast_slot(int p_slot, real_t p_weight, real_t *r_lanes) const {
+
+	// every easing equation is b + c * f(t, d), so one weight serves all lanes
+	const real_t *fi = fast_initial.ptr() + p_slot * FAST_LANES;
+	const real_t *fd = fast_delta.ptr() + p_slot * FAST_LANES;
+	for (int i = 0; i < FAST_LANES; i++) {
+		r_lanes[i] = fi[i] + fd[i] * p_weight;
+	}
+}
+
+void Tween::_apply_fast_value(int p_slot, Object *p_object, const real_t *p_lanes) {
+
+#ifdef PTRCALL_ENABLED
+	const FastSlot &fs = fast_slots[p_slot];
+
+	switch (fs.type) {
+
+		case Variant::REAL: {
+			double v = p_lanes[0];
+			const void *args[1] = { &v };
+			fs.setter->ptrcall(p_object, args, NULL);
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v(p_lanes[0], p_lanes[1]);
+			const void *args[1] = { &v };
+			fs.setter->ptrcall(p_object, args, NULL);
+		} break;
+		case Variant::COLOR: {
+			Color v(p_lanes[0], p_lanes[1], p_lanes[2], p_lanes[3]);
+			const void *args[1] = { &v };
+			fs.setter->ptrcall(p_object, args, NULL);
+		} break;
+		case Variant::RECT2: {
+			Rect2 v(p_lanes[0], p_lanes[1], p_lanes[2], p_lanes[3]);
+			const void *args[1] = { &v };
+			fs.setter->ptrcall(p_object, args, NULL);
+		} break;
+		default: {
+		}
+	}
+#endif
+}
+
 bool Tween::_apply_tween_value(InterpolateData &p_data, Variant &value) {
 
 	Object *object = ObjectDB::get_instance(p_data.id);
@@ -600,9 +775,17 @@ void Tween::_tween_process(float p_delta) {
 					object->call(data.key[0], (const Variant **)arg, data.args, error);
 				}
 			}
+		} else if (data.fast_slot >= 0 && !object->get_script_instance()) {
+			real_t weight = _run_equation(data.trans_type, data.ease_type, data.elapsed - data.delay, 0, 1, data.duration);
+			real_t lanes[FAST_LANES];
+			_eval_fast_slot(data.fast_slot, weight, lanes);
+			if (has_signal_connections(SceneStringNames::get_singleton()->tween_step)) {
+				emit_signal(SceneStringNames::get_singleton()->tween_step, object, NodePath(Vector<StringName>(), data.key, false), data.elapsed, _from_fast_lanes(fast_slots[data.fast_slot].type, lanes));
+			}
+			_apply_fast_value(data.fast_slot, object, lanes);
 		} else {
 			Variant result = _run_equation(data);
-			emit_signal("tween_step", object, NodePath(Vector<StringName>(), data.key, false), data.elapsed, result);
+			emit_signal(SceneStringNames::get_singleton()->tween_step, object, NodePath(Vector<StringName>(), data.key, false), data.elapsed, result);
 			_apply_tween_value(data, result);
 		}
 
@@ -818,6 +1001,7 @@ void Tween::_remove(Object *p_object, StringName p_key, bool first_only) {
 		}
 	}
 	for (List<List<InterpolateData>::Element *>::Element *E = for_removal.front(); E; E = E->next()) {
+		_free_fast_slot(E->get()->get().fast_slot);
 		interpolates.erase(E->get());
 	}
 }
@@ -831,6 +1015,10 @@ bool Tween::remove_all() {
 	set_active(false);
 	_set_process(false);
 	interpolates.clear();
+	fast_slots.clear();
+	fast_initial.clear();
+	fast_delta.clear();
+	fast_free_slots.clear();
 	return true;
 }
 
@@ -986,9 +1174,14 @@ bool Tween::_calc_delta_val(const Variant &p_initial_val, const Variant &p_final
 			Color f = final_val;
 			delta_val = Color(f.r - i.r, f.g - i.g, f.b - i.b, f.a - i.a);
 		} break;
+		case Variant::RECT2: {
+			Rect2 i = initial_val;
+			Rect2 f = final_val;
+			delta_val = Rect2(f.position - i.position, f.size - i.size);
+		} break;
 
 		default:
-			ERR_PRINT("Invalid param type, except(int/real/vector2/vector/matrix/matrix32/quat/aabb/transform/color)");
+			ERR_PRINT("Invalid param type, except(int/real/vector2/vector/matrix/matrix32/quat/aabb/transform/color/rect2)");
 			return false;
 	};
 	return true;
@@ -1038,6 +1231,8 @@ bool Tween::interpolate_property(Object *p_object, NodePath p_property, Variant
 	if (!_calc_delta_val(data.initial_val, data.final_val, data.delta_val))
 		return false;
 
+	data.fast_slot = _alloc_fast_slot(p_object, data.key, data.initial_val, data.delta_val);
+
 	interpolates.push_back(data);
 	return true;
 }
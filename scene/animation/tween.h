@@ -100,8 +100,37 @@ private:
 		real_t delay;
 		int args;
 		Variant arg[5];
+		int fast_slot; // index in fast_slots, -1 when the value goes through Variant
+
+		InterpolateData() { fast_slot = -1; }
+	};
+
+	// Typed path for INTER_PROPERTY on float, Vector2, Color and Rect2
+	// properties backed by a plain setter: initial and delta values stay
+	// unboxed in fast_initial/fast_delta (FAST_LANES reals per slot), one
+	// easing weight is computed per step for all lanes, and the setter is
+	// called through ptrcall instead of set_indexed().
+	enum {
+		FAST_LANES = 4
 	};
 
+	struct FastSlot {
+		MethodBind *setter;
+		Variant::Type type;
+	};
+
+	Vector<FastSlot> fast_slots;
+	Vector<real_t> fast_initial;
+	Vector<real_t> fast_delta;
+	Vector<int> fast_free_slots;
+
+	static bool _to_fast_lanes(const Variant &p_value, real_t *r_lanes);
+	static Variant _from_fast_lanes(Variant::Type p_type, const real_t *p_lanes);
+	int _alloc_fast_slot(Object *p_object, const Vector<StringName> &p_key, const Variant &p_initial_val, const Variant &p_delta_val);
+	void _free_fast_slot(int p_slot);
+	void _eval_fast_slot(int p_slot, real_t p_weight, real_t *r_lanes) const;
+	void _apply_fast_value(int p_slot, Object *p_object, const real_t *p_lanes);
+
 	String autoplay;
 	TweenProcessMode tween_process_mode;
 	bool processing;
@@ -30,6 +30,7 @@
 
 #include "container.h"
 #include "message_queue.h"
+#include "profiler.h"
 #include "scene/scene_string_names.h"
 
 void Container::_child_minsize_changed() {
@@ -80,6 +81,8 @@ void Container::remove_child_notify(Node *p_child) {
 
 void Container::_sort_children() {
 
+	PROFILE_SCOPE("Container::_sort_children");
+
 	if (!is_inside_tree())
 		return;
 
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "control.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "scene/main/canvas_layer.h"
 #include "scene/main/viewport.h"
@@ -1260,6 +1261,8 @@ Size2 Control::get_parent_area_size() const {
 
 void Control::_size_changed() {
 
+	PROFILE_SCOPE("Control::_size_changed");
+
 	if (!is_inside_tree())
 		return;
 
@@ -2447,7 +2450,7 @@ void Control::minimum_size_changed() {
 		return;
 
 	data.pending_min_size_update = true;
-	MessageQueue::get_singleton()->push_call(this, "_update_minimum_size");
+	MessageQueue::get_singleton()->push_call(this, &Control::_update_minimum_size);
 
 	if (!is_toplevel_control()) {
 		Control *pc = get_parent_control();
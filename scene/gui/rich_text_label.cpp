@@ -33,6 +33,8 @@
 #include "os/os.h"
 #include "scene/scene_string_names.h"
 
+#define LAYOUT_TIME_SLICE_USEC 4000
+
 RichTextLabel::Item *RichTextLabel::_get_next_item(Item *p_item, bool p_free) {
 
 	if (p_free) {
@@ -640,7 +642,6 @@ void RichTextLabel::_update_scroll() {
 
 		if (exceeds) {
 			scroll_visible = true;
-			main->first_invalid_line = 0;
 			scroll_w = vscroll->get_combined_minimum_size().width;
 			vscroll->show();
 			vscroll->set_anchor_and_margin(MARGIN_LEFT, ANCHOR_END, -scroll_w);
@@ -662,8 +663,7 @@ void RichTextLabel::_notification(int p_what) {
 
 		case NOTIFICATION_RESIZED: {
 
-			main->first_invalid_line = 0; //invalidate ALL
-			update();
+			update(); // lines are processed again for the new width, visible ones first
 
 		} break;
 		case NOTIFICATION_ENTER_TREE: {
@@ -683,6 +683,12 @@ void RichTextLabel::_notification(int p_what) {
 				//update();
 			}
 
+		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			if (_layout_lines(main, false, false))
+				update();
+
 		} break;
 		case NOTIFICATION_DRAW: {
 
@@ -1130,39 +1136,143 @@ bool RichTextLabel::_find_meta(Item *p_item, Variant *r_meta) {
 
 void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
 
-	if (p_frame->first_invalid_line == p_frame->lines.size())
-		return;
+	int line_count = p_frame->lines.size();
+	bool invalid = p_frame->first_invalid_line < line_count;
 
-	//validate invalid lines
-	Size2 size = get_size();
-	Rect2 text_rect = _get_text_rect();
+	if (invalid) {
+
+		Ref<Font> base_font = get_font("normal_font");
+
+		for (int i = p_frame->first_invalid_line; i < line_count; i++) {
+
+			Line &l = p_frame->lines[i];
+			if (l.offset_caches.empty())
+				l.height_cache = base_font->get_height(); //estimate until processed
+			l.layout_width = -1;
+			l.height_accum_cache = l.height_cache;
+
+			if (i > 0)
+				l.height_accum_cache += p_frame->lines[i - 1].height_accum_cache;
+		}
+
+		main->first_invalid_line = line_count;
+	}
+
+	if (_layout_lines(p_frame, true, invalid) || invalid)
+		set_process_internal(true); //process the remaining lines in the background
+}
+
+void RichTextLabel::_layout_line(ItemFrame *p_frame, int p_line, int p_width, const Ref<Font> &p_base_font) {
+
+	int y = 0;
+	_process_line(p_frame, _get_text_rect().get_position(), y, p_width, p_line, PROCESS_CACHE, p_base_font, Color());
+	p_frame->lines[p_line].height_cache = y;
+	p_frame->lines[p_line].layout_width = p_width;
+}
+
+bool RichTextLabel::_layout_lines(ItemFrame *p_frame, bool p_visible_only, bool p_update_scroll) {
+
+	int line_count = p_frame->lines.size();
+	if (line_count == 0)
+		return false;
 
+	Size2 size = get_size();
+	int width = _get_text_rect().get_size().width - scroll_w;
 	Ref<Font> base_font = get_font("normal_font");
+	bool follow = scroll_follow && scroll_following;
+
+	// Remember the line at the top of the view, so it stays in place while lines
+	// above it change from estimated (or outdated) heights to the actual ones.
+	int ofs = vscroll->get_value();
+	int anchor = 0;
+	int anchor_to = line_count - 1;
+	while (anchor < anchor_to) {
+		int mid = (anchor + anchor_to) / 2;
+		if (p_frame->lines[mid].height_accum_cache < ofs)
+			anchor = mid + 1;
+		else
+			anchor_to = mid;
+	}
+	int anchor_ofs = ofs - (p_frame->lines[anchor].height_accum_cache - p_frame->lines[anchor].height_cache);
+
+	int first_changed = line_count;
+
+	if (p_visible_only) {
 
-	for (int i = p_frame->first_invalid_line; i < p_frame->lines.size(); i++) {
+		if (follow) {
 
-		int y = 0;
-		_process_line(p_frame, text_rect.get_position(), y, text_rect.get_size().width - scroll_w, i, PROCESS_CACHE, base_font, Color());
-		p_frame->lines[i].height_cache = y;
-		p_frame->lines[i].height_accum_cache = y;
+			int h = 0;
+			for (int i = line_count - 1; i >= 0 && h < size.height; i--) {
 
+				if (p_frame->lines[i].layout_width != width) {
+					_layout_line(p_frame, i, width, base_font);
+					first_changed = i;
+				}
+				h += p_frame->lines[i].height_cache;
+			}
+		} else {
+
+			// start one line early, drawing also includes the partially visible line above
+			int from = MAX(anchor - 1, 0);
+			int h = -anchor_ofs - (from < anchor ? p_frame->lines[from].height_cache : 0);
+			for (int i = from; i < line_count && h < size.height; i++) {
+
+				if (p_frame->lines[i].layout_width != width) {
+					_layout_line(p_frame, i, width, base_font);
+					first_changed = MIN(first_changed, i);
+				}
+				h += p_frame->lines[i].height_cache;
+			}
+		}
+	} else {
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		bool pending = false;
+
+		for (int i = 0; i < line_count; i++) {
+
+			if (layout_cursor >= line_count)
+				layout_cursor = 0;
+
+			if (p_frame->lines[layout_cursor].layout_width != width) {
+
+				if (OS::get_singleton()->get_ticks_usec() - begin > LAYOUT_TIME_SLICE_USEC) {
+					pending = true;
+					break;
+				}
+				_layout_line(p_frame, layout_cursor, width, base_font);
+				first_changed = MIN(first_changed, layout_cursor);
+			}
+			layout_cursor++;
+		}
+
+		if (!pending)
+			set_process_internal(false);
+	}
+
+	if (first_changed == line_count && !p_update_scroll)
+		return false;
+
+	for (int i = first_changed; i < line_count; i++) {
+
+		p_frame->lines[i].height_accum_cache = p_frame->lines[i].height_cache;
 		if (i > 0)
 			p_frame->lines[i].height_accum_cache += p_frame->lines[i - 1].height_accum_cache;
 	}
 
-	int total_height = 0;
-	if (p_frame->lines.size())
-		total_height = p_frame->lines[p_frame->lines.size() - 1].height_accum_cache + get_stylebox("normal")->get_minimum_size().height;
-
-	main->first_invalid_line = p_frame->lines.size();
+	int total_height = p_frame->lines[line_count - 1].height_accum_cache + get_stylebox("normal")->get_minimum_size().height;
 
 	updating_scroll = true;
 	vscroll->set_max(total_height);
 	vscroll->set_page(size.height);
-	if (scroll_follow && scroll_following)
+	if (follow)
 		vscroll->set_value(total_height - size.height);
+	else if (first_changed < anchor)
+		vscroll->set_value(p_frame->lines[anchor].height_accum_cache - p_frame->lines[anchor].height_cache + anchor_ofs);
 
 	updating_scroll = false;
+
+	return first_changed < line_count;
 }
 
 void RichTextLabel::_invalidate_current_line(ItemFrame *p_frame) {
@@ -1224,6 +1334,7 @@ void RichTextLabel::add_text(const String &p_text) {
 			if (item->type != ITEM_NEWLINE)
 				current_frame->lines[current_frame->lines.size() - 1].from = item;
 			_invalidate_current_line(current_frame);
+			_trim_lines();
 		}
 
 		pos = end + 1;
@@ -1292,6 +1403,7 @@ void RichTextLabel::add_newline() {
 	_add_item(item, false);
 	current_frame->lines.resize(current_frame->lines.size() + 1);
 	_invalidate_current_line(current_frame);
+	_trim_lines();
 }
 
 bool RichTextLabel::remove_line(const int p_line) {
@@ -1314,6 +1426,106 @@ bool RichTextLabel::remove_line(const int p_line) {
 	return true;
 }
 
+int RichTextLabel::_get_item_last_line(Item *p_item) const {
+
+	Item *it = p_item;
+	while (it->type != ITEM_TABLE && it->subitems.size())
+		it = it->subitems.back()->get();
+
+	return it->line;
+}
+
+int RichTextLabel::_get_item_main_line(Item *p_item) const {
+
+	int line = p_item->line;
+	for (Item *it = p_item; it->parent && it != main; it = it->parent) {
+		if (it->type == ITEM_TABLE)
+			line = it->line; //items in cells use the line of the table that holds them
+	}
+
+	return line;
+}
+
+void RichTextLabel::_trim_items(Item *p_item, int p_line) {
+
+	while (p_item->subitems.size()) {
+
+		Item *it = p_item->subitems.front()->get();
+
+		if (_get_item_last_line(it) >= p_line) {
+			// partially kept, only remove its leading children
+			if (it->type != ITEM_TABLE)
+				_trim_items(it, p_line);
+			break;
+		}
+
+		memdelete(it);
+		p_item->subitems.pop_front();
+	}
+}
+
+void RichTextLabel::_shift_item_lines(Item *p_item, int p_amount) {
+
+	for (List<Item *>::Element *E = p_item->subitems.front(); E; E = E->next()) {
+
+		Item *it = E->get();
+		it->line = MAX(it->line - p_amount, 0);
+		if (it->type == ITEM_NEWLINE) {
+			ItemNewline *newline = static_cast<ItemNewline *>(it);
+			newline->line = MAX(newline->line - p_amount, 0);
+		}
+
+		if (it->type != ITEM_TABLE)
+			_shift_item_lines(it, p_amount);
+	}
+}
+
+void RichTextLabel::_trim_lines() {
+
+	if (max_lines <= 0 || current_frame != main)
+		return;
+
+	// Drop old lines in batches, so shifting the remaining lines and items is
+	// amortized over many appends when used as a bounded log.
+	int line_count = main->lines.size();
+	if (line_count <= max_lines + MAX(max_lines / 8, 1))
+		return;
+
+	int drop = line_count - max_lines;
+
+	if ((selection.click && _get_item_main_line(selection.click) < drop) || (selection.active && selection.from && _get_item_main_line(selection.from) < drop)) {
+		selection.click = NULL;
+		selection.active = false;
+	}
+
+	if (meta_hovering && _get_item_main_line(meta_hovering) < drop)
+		meta_hovering = NULL;
+
+	_trim_items(main, drop);
+	_shift_item_lines(main, drop);
+
+	int dropped_height = main->lines[drop - 1].height_accum_cache;
+
+	for (int i = drop; i < line_count; i++) {
+
+		main->lines[i - drop] = main->lines[i];
+		main->lines[i - drop].height_accum_cache -= dropped_height;
+	}
+	main->lines.resize(max_lines);
+	main->lines[0].from = main; // its old first item was dropped, walk from the root like remove_line()
+	main->first_invalid_line = MAX(main->first_invalid_line - drop, 0);
+	layout_cursor = 0;
+
+	if (!(scroll_follow && scroll_following)) {
+
+		updating_scroll = true;
+		vscroll->set_value(vscroll->get_value() - dropped_height);
+		updating_scroll = false;
+	}
+
+	update();
+}
+
 void RichTextLabel::push_font(const Ref<Font> &p_font) {
 
 	ERR_FAIL_COND(current->type == ITEM_TABLE);
@@ -1460,6 +1672,17 @@ int RichTextLabel::get_tab_size() const {
 	return tab_size;
 }
 
+void RichTextLabel::set_max_lines(int p_lines) {
+
+	max_lines = p_lines;
+	_trim_lines();
+}
+
+int RichTextLabel::get_max_lines() const {
+
+	return max_lines;
+}
+
 void RichTextLabel::set_meta_underline(bool p_underline) {
 
 	underline_meta = p_underline;
@@ -1518,11 +1741,58 @@ Error RichTextLabel::parse_bbcode(const String &p_bbcode) {
 	return append_bbcode(p_bbcode);
 }
 
+// View of a tag inside the BBCode source, so it can be matched and kept in
+// the tag stack without allocating a String for every tag.
+struct BBCodeTag {
+
+	const CharType *str;
+	int len;
+
+	bool operator==(const char *p_str) const {
+
+		int i = 0;
+		for (; i < len; i++) {
+			if (p_str[i] == 0 || str[i] != (CharType)p_str[i])
+				return false;
+		}
+		return p_str[i] == 0;
+	}
+
+	bool operator==(const BBCodeTag &p_tag) const {
+
+		if (len != p_tag.len)
+			return false;
+		for (int i = 0; i < len; i++) {
+			if (str[i] != p_tag.str[i])
+				return false;
+		}
+		return true;
+	}
+
+	bool begins_with(const char *p_str) const {
+
+		for (int i = 0; p_str[i]; i++) {
+			if (i >= len || str[i] != (CharType)p_str[i])
+				return false;
+		}
+		return true;
+	}
+
+	BBCodeTag left(int p_len) const { return BBCodeTag(str, MIN(p_len, len)); }
+	BBCodeTag right(int p_from) const { return BBCodeTag(str + MIN(p_from, len), len - MIN(p_from, len)); }
+	String substr(int p_from) const { return p_from < len ? String(str + p_from, len - p_from) : String(); }
+
+	BBCodeTag(const CharType *p_str = NULL, int p_len = 0) {
+		str = p_str;
+		len = p_len;
+	}
+};
+
 Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 
 	int pos = 0;
 
-	List<String> tag_stack;
+	Vector<BBCodeTag> tag_stack;
 	Ref<Font> normal_font = get_font("normal_font");
 	Ref<Font> bold_font = get_font("bold_font");
 	Ref<Font> italics_font = get_font("italics_font");
@@ -1558,17 +1828,18 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 			break;
 		}
 
-		String tag = p_bbcode.substr(brk_pos + 1, brk_end - brk_pos - 1);
+		BBCodeTag tag(p_bbcode.c_str() + brk_pos + 1, brk_end - brk_pos - 1);
 
 		if (tag.begins_with("/") && tag_stack.size()) {
 
-			bool tag_ok = tag_stack.size() && tag_stack.front()->get() == tag.substr(1, tag.length());
+			const BBCodeTag &open_tag = tag_stack[tag_stack.size() - 1];
+			bool tag_ok = open_tag == tag.right(1);
 
-			if (tag_stack.front()->get() == "b")
+			if (open_tag == "b")
 				in_bold = false;
-			if (tag_stack.front()->get() == "i")
+			if (open_tag == "i")
 				in_italics = false;
-			if (tag_stack.front()->get() == "indent")
+			if (open_tag == "indent")
 				indent_level--;
 
 			if (!tag_ok) {
@@ -1578,9 +1849,9 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 				continue;
 			}
 
-			tag_stack.pop_front();
+			tag_stack.resize(tag_stack.size() - 1);
 			pos = brk_end + 1;
-			if (tag != "/img")
+			if (!(tag == "/img"))
 				pop();
 
 		} else if (tag == "b") {
@@ -1592,7 +1863,7 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 			else
 				push_font(bold_font);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "i") {
 
 			//use italics font
@@ -1602,86 +1873,86 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 			else
 				push_font(italics_font);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "code") {
 
 			//use monospace font
 			push_font(mono_font);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag.begins_with("table=")) {
 
-			int columns = tag.substr(6, tag.length()).to_int();
+			int columns = tag.substr(6).to_int();
 			if (columns < 1)
 				columns = 1;
 			//use monospace font
 			push_table(columns);
 			pos = brk_end + 1;
-			tag_stack.push_front("table");
+			tag_stack.push_back(tag.left(5));
 		} else if (tag == "cell") {
 
 			push_cell();
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag.begins_with("cell=")) {
 
-			int ratio = tag.substr(6, tag.length()).to_int();
+			int ratio = tag.substr(6).to_int();
 			if (ratio < 1)
 				ratio = 1;
 			//use monospace font
 			set_table_column_expand(get_current_table_column(), true, ratio);
 			push_cell();
 			pos = brk_end + 1;
-			tag_stack.push_front("cell");
+			tag_stack.push_back(tag.left(4));
 		} else if (tag == "u") {
 
 			//use underline
 			push_underline();
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "s") {
 
 			//use strikethrough (not supported underline instead)
 			push_underline();
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "center") {
 
 			//use underline
 			push_align(ALIGN_CENTER);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "fill") {
 
 			//use underline
 			push_align(ALIGN_FILL);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "right") {
 
 			//use underline
 			push_align(ALIGN_RIGHT);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "ul") {
 
 			//use underline
 			push_list(LIST_DOTS);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "ol") {
 
 			//use underline
 			push_list(LIST_NUMBERS);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag == "indent") {
 
 			//use underline
 			indent_level++;
 			push_indent(indent_level);
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 
 		} else if (tag == "url") {
 
@@ -1693,14 +1964,14 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 			push_meta(url);
 
 			pos = brk_end + 1;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 
 		} else if (tag.begins_with("url=")) {
 
-			String url = tag.substr(4, tag.length());
+			String url = tag.substr(4);
 			push_meta(url);
 			pos = brk_end + 1;
-			tag_stack.push_front("url");
+			tag_stack.push_back(tag.left(3));
 		} else if (tag == "img") {
 
 			//use strikethrough (not supported underline instead)
@@ -1714,10 +1985,10 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 				add_image(texture);
 
 			pos = end;
-			tag_stack.push_front(tag);
+			tag_stack.push_back(tag);
 		} else if (tag.begins_with("color=")) {
 
-			String col = tag.substr(6, tag.length());
+			String col = tag.substr(6);
 			Color color;
 
 			if (col.begins_with("#"))
@@ -1759,11 +2030,11 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 
 			push_color(color);
 			pos = brk_end + 1;
-			tag_stack.push_front("color");
+			tag_stack.push_back(tag.left(5));
 
 		} else if (tag.begins_with("font=")) {
 
-			String fnt = tag.substr(5, tag.length());
+			String fnt = tag.substr(5);
 
 			Ref<Font> font = ResourceLoader::load(fnt, "Font");
 			if (font.is_valid())
@@ -1772,7 +2043,7 @@ Error RichTextLabel::append_bbcode(const String &p_bbcode) {
 				push_font(normal_font);
 
 			pos = brk_end + 1;
-			tag_stack.push_front("font");
+			tag_stack.push_back(tag.left(4));
 
 		} else {
 
@@ -2027,6 +2298,9 @@ void RichTextLabel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_tab_size", "spaces"), &RichTextLabel::set_tab_size);
 	ClassDB::bind_method(D_METHOD("get_tab_size"), &RichTextLabel::get_tab_size);
 
+	ClassDB::bind_method(D_METHOD("set_max_lines", "lines"), &RichTextLabel::set_max_lines);
+	ClassDB::bind_method(D_METHOD("get_max_lines"), &RichTextLabel::get_max_lines);
+
 	ClassDB::bind_method(D_METHOD("set_selection_enabled", "enabled"), &RichTextLabel::set_selection_enabled);
 	ClassDB::bind_method(D_METHOD("is_selection_enabled"), &RichTextLabel::is_selection_enabled);
 
@@ -2059,6 +2333,7 @@ void RichTextLabel::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "meta_underlined"), "set_meta_underline", "is_meta_underlined");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "tab_size", PROPERTY_HINT_RANGE, "0,24,1"), "set_tab_size", "get_tab_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_lines", PROPERTY_HINT_RANGE, "0,1000000,1"), "set_max_lines", "get_max_lines");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "text"), "set_text", "get_text");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "scroll_active"), "set_scroll_active", "is_scroll_active");
@@ -2153,6 +2428,9 @@ RichTextLabel::RichTextLabel() {
 	visible_characters = -1;
 	percent_visible = 1;
 	visible_line_count = 0;
+	layout_cursor = 0;
+	max_lines = 0;
+	meta_hovering = NULL;
 
 	set_clip_contents(true);
 }
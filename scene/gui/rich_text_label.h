@@ -87,10 +87,15 @@ private:
 		int height_accum_cache;
 		int char_count;
 		int minimum_width;
+		int layout_width; // width the caches were processed with, -1 if they need processing
 
 		Line() {
 			from = NULL;
+			height_cache = 0;
+			height_accum_cache = 0;
 			char_count = 0;
+			minimum_width = 0;
+			layout_width = -1;
 		}
 	};
 
@@ -221,6 +226,8 @@ private:
 	bool updating_scroll;
 	int current_idx;
 	int visible_line_count;
+	int layout_cursor;
+	int max_lines;
 
 	int tab_size;
 	bool underline_meta;
@@ -233,10 +240,18 @@ private:
 
 	void _invalidate_current_line(ItemFrame *p_frame);
 	void _validate_line_caches(ItemFrame *p_frame);
+	void _layout_line(ItemFrame *p_frame, int p_line, int p_width, const Ref<Font> &p_base_font);
+	bool _layout_lines(ItemFrame *p_frame, bool p_visible_only, bool p_update_scroll);
 
 	void _add_item(Item *p_item, bool p_enter = false, bool p_ensure_newline = false);
 	void _remove_item(Item *p_item, const int p_line, const int p_subitem_line);
 
+	int _get_item_last_line(Item *p_item) const;
+	int _get_item_main_line(Item *p_item) const;
+	void _trim_items(Item *p_item, int p_line);
+	void _shift_item_lines(Item *p_item, int p_amount);
+	void _trim_lines();
+
 	struct ProcessState {
 
 		int line_width;
@@ -332,6 +347,9 @@ public:
 	void set_tab_size(int p_spaces);
 	int get_tab_size() const;
 
+	void set_max_lines(int p_lines);
+	int get_max_lines() const;
+
 	bool search(const String &p_string, bool p_from_selection = false);
 
 	void scroll_to_line(int p_line);
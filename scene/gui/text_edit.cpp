@@ -39,6 +39,9 @@
 
 #define TAB_PIXELS
 
+#define LINE_WIDTH_MEASURE_USEC 2000
+#define LINE_WIDTH_MEASURE_CHUNK 256
+
 inline bool _is_symbol(CharType c) {
 
 	return is_symbol(c);
@@ -102,12 +105,49 @@ static CharType _get_right_pair_symbol(CharType c) {
 
 void TextEdit::Text::set_font(const Ref<Font> &p_font) {
 
+	if (font == p_font)
+		return;
+
 	font = p_font;
+	clear_caches(); // widths are measured again lazily, see measure_lines()
 }
 
 void TextEdit::Text::set_indent_size(int p_indent_size) {
 
+	if (indent_size == p_indent_size)
+		return;
+
 	indent_size = p_indent_size;
+	clear_caches();
+}
+
+void TextEdit::Text::_add_width(int p_width, bool p_hidden) const {
+
+	Map<int, int> &counts = p_hidden ? hidden_width_count : width_count;
+	Map<int, int>::Element *E = counts.find(p_width);
+	if (E)
+		E->get()++;
+	else
+		counts.insert(p_width, 1);
+}
+
+void TextEdit::Text::_remove_width(int p_width, bool p_hidden) const {
+
+	Map<int, int> &counts = p_hidden ? hidden_width_count : width_count;
+	Map<int, int>::Element *E = counts.find(p_width);
+	ERR_FAIL_COND(!E);
+	if (--E->get() == 0)
+		counts.erase(E);
+}
+
+void TextEdit::Text::_invalidate_width(int p_line) {
+
+	if (text[p_line].width_cache == -1)
+		return;
+
+	_remove_width(text[p_line].width_cache, text[p_line].hidden);
+	text[p_line].width_cache = -1;
+	unmeasured_lines++;
 }
 
 void TextEdit::Text::_update_line_cache(int p_line) const {
@@ -135,7 +175,13 @@ void TextEdit::Text::_update_line_cache(int p_line) const {
 		}
 	}
 
+	if (text[p_line].width_cache == -1)
+		unmeasured_lines--;
+	else
+		_remove_width(text[p_line].width_cache, text[p_line].hidden);
+
 	text[p_line].width_cache = w;
+	_add_width(w, text[p_line].hidden);
 
 	//update regions
 
@@ -240,33 +286,70 @@ void TextEdit::Text::clear_caches() {
 
 	for (int i = 0; i < text.size(); i++)
 		text[i].width_cache = -1;
+
+	width_count.clear();
+	hidden_width_count.clear();
+	unmeasured_lines = text.size();
+	measure_from = 0;
 }
 
 void TextEdit::Text::clear() {
 
 	text.clear();
+	width_count.clear();
+	hidden_width_count.clear();
+	unmeasured_lines = 0;
+	measure_from = 0;
 	insert(0, "");
 }
 
 int TextEdit::Text::get_max_width(bool p_exclude_hidden) const {
-	//quite some work.. but should be fast enough.
+	// Only lines measured so far are taken into account, use measure_lines() to catch up.
 
-	int max = 0;
-	for (int i = 0; i < text.size(); i++) {
-		if (!p_exclude_hidden || !is_hidden(i))
-			max = MAX(max, get_line_width(i));
-	}
+	int max = width_count.size() ? width_count.back()->key() : 0;
+	if (!p_exclude_hidden && hidden_width_count.size())
+		max = MAX(max, hidden_width_count.back()->key());
 	return max;
 }
 
+int TextEdit::Text::measure_lines(int p_max_lines) const {
+
+	int measured = 0;
+	for (int i = 0; i < text.size() && unmeasured_lines > 0 && measured < p_max_lines; i++) {
+
+		if (measure_from >= text.size())
+			measure_from = 0;
+
+		if (text[measure_from].width_cache == -1) {
+			_update_line_cache(measure_from);
+			measured++;
+		}
+		measure_from++;
+	}
+	return measured;
+}
+
 void TextEdit::Text::set(int p_line, const String &p_text) {
 
 	ERR_FAIL_INDEX(p_line, text.size());
 
-	text[p_line].width_cache = -1;
+	_invalidate_width(p_line);
 	text[p_line].data = p_text;
 }
 
+void TextEdit::Text::set_hidden(int p_line, bool p_hidden) {
+
+	Line &line = text[p_line];
+	if (line.hidden == p_hidden)
+		return;
+
+	if (line.width_cache != -1) {
+		_remove_width(line.width_cache, line.hidden);
+		_add_width(line.width_cache, p_hidden);
+	}
+	line.hidden = p_hidden;
+}
+
 void TextEdit::Text::insert(int p_at, const String &p_text) {
 
 	Line line;
@@ -276,12 +359,40 @@ void TextEdit::Text::insert(int p_at, const String &p_text) {
 	line.width_cache = -1;
 	line.data = p_text;
 	text.insert(p_at, line);
+	unmeasured_lines++;
 }
 void TextEdit::Text::remove(int p_at) {
 
+	if (text[p_at].width_cache == -1)
+		unmeasured_lines--;
+	else
+		_remove_width(text[p_at].width_cache, text[p_at].hidden);
+
 	text.remove(p_at);
 }
 
+bool TextEdit::_measure_line_widths() {
+
+	// Measure lines that lost their cached width (new text, font change) in time
+	// slices, so the maximum width used by the horizontal scrollbar catches up over
+	// a few frames instead of blocking on the whole document.
+	if (!text.has_unmeasured_lines()) {
+		set_process_internal(false);
+		return false;
+	}
+
+	int prev_max_width = text.get_max_width(true);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	while (text.has_unmeasured_lines() && OS::get_singleton()->get_ticks_usec() - begin < LINE_WIDTH_MEASURE_USEC) {
+		text.measure_lines(LINE_WIDTH_MEASURE_CHUNK);
+	}
+
+	set_process_internal(text.has_unmeasured_lines());
+
+	return text.get_max_width(true) != prev_max_width;
+}
+
 void TextEdit::_update_scrollbars() {
 
 	Size2 size = get_size();
@@ -305,6 +416,7 @@ void TextEdit::_update_scrollbars() {
 
 	int vscroll_pixels = v_scroll->get_combined_minimum_size().width;
 	int visible_width = size.width - cache.style_normal->get_minimum_size().width;
+	_measure_line_widths();
 	int total_width = text.get_max_width(true) + vmin.x;
 
 	if (line_numbers)
@@ -533,6 +645,11 @@ void TextEdit::_notification(int p_what) {
 			draw_caret = false;
 			update();
 		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			if (_measure_line_widths())
+				update();
+		} break;
 		case NOTIFICATION_FIXED_PROCESS: {
 			if (scrolling && v_scroll->get_value() != target_v_scroll) {
 				double target_y = target_v_scroll - v_scroll->get_value();
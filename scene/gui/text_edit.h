@@ -151,10 +151,18 @@ class TextEdit : public Control {
 	private:
 		const Vector<ColorRegion> *color_regions;
 		mutable Vector<Line> text;
+		// Measured width -> amount of lines with that width, so the maximum is always the last key.
+		mutable Map<int, int> width_count;
+		mutable Map<int, int> hidden_width_count;
+		mutable int unmeasured_lines;
+		mutable int measure_from;
 		Ref<Font> font;
 		int indent_size;
 
 		void _update_line_cache(int p_line) const;
+		void _add_width(int p_width, bool p_hidden) const;
+		void _remove_width(int p_width, bool p_hidden) const;
+		void _invalidate_width(int p_line);
 
 	public:
 		void set_indent_size(int p_indent_size);
@@ -162,13 +170,15 @@ class TextEdit : public Control {
 		void set_color_regions(const Vector<ColorRegion> *p_regions) { color_regions = p_regions; }
 		int get_line_width(int p_line) const;
 		int get_max_width(bool p_exclude_hidden = false) const;
+		bool has_unmeasured_lines() const { return unmeasured_lines > 0; }
+		int measure_lines(int p_max_lines) const;
 		const Map<int, ColorRegionInfo> &get_color_region_info(int p_line) const;
 		void set(int p_line, const String &p_text);
 		void set_marked(int p_line, bool p_marked) { text[p_line].marked = p_marked; }
 		bool is_marked(int p_line) const { return text[p_line].marked; }
 		void set_breakpoint(int p_line, bool p_breakpoint) { text[p_line].breakpoint = p_breakpoint; }
 		bool is_breakpoint(int p_line) const { return text[p_line].breakpoint; }
-		void set_hidden(int p_line, bool p_hidden) { text[p_line].hidden = p_hidden; }
+		void set_hidden(int p_line, bool p_hidden);
 		bool is_hidden(int p_line) const { return text[p_line].hidden; }
 		void insert(int p_at, const String &p_text);
 		void remove(int p_at);
@@ -176,7 +186,11 @@ class TextEdit : public Control {
 		void clear();
 		void clear_caches();
 		_FORCE_INLINE_ const String &operator[](int p_line) const { return text[p_line].data; }
-		Text() { indent_size = 4; }
+		Text() {
+			indent_size = 4;
+			unmeasured_lines = 0;
+			measure_from = 0;
+		}
 	};
 
 	struct TextOperation {
@@ -326,6 +340,7 @@ class TextEdit : public Control {
 	double get_scroll_line_diff() const;
 	void _scroll_moved(double);
 	void _update_scrollbars();
+	bool _measure_line_widths();
 	void _v_scroll_input();
 	void _click_selection_held();
 
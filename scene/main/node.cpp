@@ -196,6 +196,7 @@ void Node::_propagate_enter_tree() {
 		data.viewport = data.parent->data.viewport;
 
 	data.inside_tree = true;
+	_order_insert_after(_order_get_prev());
 
 	for (Map<StringName, GroupData>::Element *E = data.grouped.front(); E; E = E->next()) {
 		E->get().group = data.tree->add_to_group(E->key(), this);
@@ -258,6 +259,7 @@ void Node::_propagate_exit_tree() {
 	if (data.tree)
 		data.tree->tree_changed();
 
+	_order_remove();
 	data.inside_tree = false;
 	data.ready_notified = false;
 	data.tree = NULL;
@@ -292,6 +294,10 @@ void Node::move_child(Node *p_child, int p_pos) {
 	data.children.remove(p_child->data.pos);
 	data.children.insert(p_pos, p_child);
 
+	if (data.child_index_collisions) {
+		_clear_child_index(); // which of the same-named children comes first may have changed
+	}
+
 	if (data.tree) {
 		data.tree->tree_changed();
 	}
@@ -302,6 +308,12 @@ void Node::move_child(Node *p_child, int p_pos) {
 
 		data.children[i]->data.pos = i;
 	}
+	if (p_child->data.inside_tree) {
+		// only the moved subtree changes place in tree order
+		p_child->_order_remove_subtree();
+		Node *prev = p_child->_order_get_prev();
+		p_child->_order_relink_subtree(prev);
+	}
 	// notification second
 	move_child_notify(p_child);
 	for (int i = motion_from; i <= motion_to; i++) {
@@ -567,7 +579,13 @@ StringName Node::get_name() const {
 
 void Node::_set_name_nocheck(const StringName &p_name) {
 
+	StringName old_name = data.name;
 	data.name = p_name;
+
+	if (data.parent && data.parent->data.child_index) {
+		data.parent->_child_index_remove(this, old_name);
+		data.parent->_child_index_add(this);
+	}
 }
 
 void Node::set_name(const String &p_name) {
@@ -575,11 +593,16 @@ void Node::set_name(const String &p_name) {
 	String name = p_name.replace(":", "").replace("/", "").replace("@", "");
 
 	ERR_FAIL_COND(name == "");
+	StringName old_name = data.name;
 	data.name = name;
 
 	if (data.parent) {
 
 		data.parent->_validate_child_name(this);
+		if (data.parent->data.child_index) {
+			data.parent->_child_index_remove(this, old_name);
+			data.parent->_child_index_add(this);
+		}
 	}
 
 	propagate_notification(NOTIFICATION_PATH_CHANGED);
@@ -625,16 +648,31 @@ void Node::_validate_child_name(Node *p_child, bool p_force_human_readable) {
 			//new unique name must be assigned
 			unique = false;
 		} else {
-			//check if exists
-			Node **children = data.children.ptrw();
-			int cc = data.children.size();
 
-			for (int i = 0; i < cc; i++) {
-				if (children[i] == p_child)
-					continue;
-				if (children[i]->data.name == p_child->data.name) {
-					unique = false;
-					break;
+			bool scan = true;
+
+			if (data.children.size() > CHILD_INDEX_THRESHOLD) {
+				//check if exists, through the name index
+				Node *existing = _get_child_by_name(p_child->data.name);
+				// p_child may be indexed under the name already (set_name() renames before
+				// validating), and then only a scan tells whether another child shares it
+				scan = existing == p_child && data.child_index_collisions;
+				unique = !existing || existing == p_child;
+			}
+
+			if (scan) {
+				//check if exists
+				Node **children = data.children.ptrw();
+				int cc = data.children.size();
+
+				unique = true;
+				for (int i = 0; i < cc; i++) {
+					if (children[i] == p_child)
+						continue;
+					if (children[i]->data.name == p_child->data.name) {
+						unique = false;
+						break;
+					}
 				}
 			}
 		}
@@ -695,12 +733,17 @@ String Node::_generate_serial_child_name(Node *p_child) {
 	for (;;) {
 		String attempt = (name + (num > 0 || explicit_zero ? nnsep + itos(num).pad_zeros(num_places) : "")).strip_edges();
 		bool found = false;
-		for (int i = 0; i < data.children.size(); i++) {
-			if (data.children[i] == p_child)
-				continue;
-			if (data.children[i]->data.name == attempt) {
-				found = true;
-				break;
+		if (data.children.size() > CHILD_INDEX_THRESHOLD) {
+			Node *existing = _get_child_by_name(attempt);
+			found = existing && existing != p_child;
+		} else {
+			for (int i = 0; i < data.children.size(); i++) {
+				if (data.children[i] == p_child)
+					continue;
+				if (data.children[i]->data.name == attempt) {
+					found = true;
+					break;
+				}
 			}
 		}
 		if (!found) {
@@ -728,6 +771,7 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
 	p_child->data.parent = this;
+	_child_index_add(p_child);
 	p_child->notification(NOTIFICATION_PARENTED);
 
 	if (data.tree) {
@@ -769,6 +813,61 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	_add_child_nocheck(p_child, p_child->data.name);
 }
 
+void Node::add_children(const Array &p_children, bool p_legible_unique_name) {
+
+	if (data.blocked > 0) {
+		ERR_EXPLAIN("Parent node is busy setting up children, add_children() failed. Consider using call_deferred(\"add_children\", children) instead.");
+		ERR_FAIL_COND(data.blocked > 0);
+	}
+
+	if (!data.child_index && data.children.size() + p_children.size() > CHILD_INDEX_THRESHOLD) {
+		// build the index up front, so validating each name does not scan the siblings
+		_build_child_index();
+	}
+
+	// parent and name all the children first, then let them enter the tree
+
+	Vector<Node *> added;
+	added.resize(p_children.size());
+	int added_count = 0;
+
+	for (int i = 0; i < p_children.size(); i++) {
+
+		Node *child = Object::cast_to<Node>(p_children[i]);
+
+		ERR_EXPLAIN("Can't add children that are not nodes.");
+		ERR_CONTINUE(!child);
+		ERR_EXPLAIN("Can't add child '" + child->get_name() + "' to itself.");
+		ERR_CONTINUE(child == this);
+		ERR_EXPLAIN("Can't add child '" + child->get_name() + "' to '" + get_name() + "', already has a parent.");
+		ERR_CONTINUE(child->data.parent);
+
+		_validate_child_name(child, p_legible_unique_name);
+
+		child->data.pos = data.children.size();
+		data.children.push_back(child);
+		child->data.parent = this;
+		_child_index_add(child);
+		child->notification(NOTIFICATION_PARENTED);
+
+		added[added_count++] = child;
+	}
+
+	for (int i = 0; i < added_count; i++) {
+
+		Node *child = added[i];
+		if (child->data.parent != this)
+			continue; // removed while an earlier child was notified
+
+		if (data.tree && !child->data.inside_tree) {
+			child->_set_tree(data.tree);
+		}
+
+		child->data.parent_owned = data.in_constructor;
+		add_child_notify(child);
+	}
+}
+
 void Node::add_child_below_node(Node *p_node, Node *p_child, bool p_legible_unique_name) {
 	add_child(p_child, p_legible_unique_name);
 
@@ -819,13 +918,9 @@ void Node::remove_child(Node *p_child) {
 	}
 
 	int idx = -1;
-	for (int i = 0; i < data.children.size(); i++) {
-
-		if (data.children[i] == p_child) {
+	if (p_child->data.parent == this && p_child->data.pos >= 0 && p_child->data.pos < data.children.size() && data.children[p_child->data.pos] == p_child) {
 
-			idx = i;
-			break;
-		}
+		idx = p_child->data.pos;
 	}
 
 	ERR_FAIL_COND(idx == -1);
@@ -840,6 +935,7 @@ void Node::remove_child(Node *p_child) {
 	p_child->notification(NOTIFICATION_UNPARENTED);
 
 	data.children.remove(idx);
+	_child_index_remove(p_child, p_child->data.name);
 
 	for (int i = idx; i < data.children.size(); i++) {
 
@@ -864,9 +960,78 @@ Node *Node::get_child(int p_index) const {
 	return data.children[p_index];
 }
 
+void Node::_build_child_index() const {
+
+	if (!data.child_index)
+		data.child_index = memnew((OAHashMap<StringName, Node *, StringNameHasher>)(data.children.size() * 2));
+
+	data.child_index->clear();
+	data.child_index_collisions = false;
+
+	for (int i = 0; i < data.children.size(); i++) {
+
+		Node *child = data.children[i];
+		if (data.child_index->has(child->data.name)) {
+			// the first child with a name wins, like a linear search would
+			data.child_index_collisions = true;
+			continue;
+		}
+		data.child_index->set(child->data.name, child);
+	}
+}
+
+void Node::_clear_child_index() {
+
+	if (data.child_index) {
+		memdelete(data.child_index);
+		data.child_index = NULL;
+	}
+	data.child_index_collisions = false;
+}
+
+void Node::_child_index_add(Node *p_child) {
+
+	if (!data.child_index)
+		return;
+
+	Node **existing = data.child_index->getptr(p_child->data.name);
+	if (existing) {
+		if (*existing != p_child)
+			data.child_index_collisions = true;
+		return;
+	}
+	data.child_index->set(p_child->data.name, p_child);
+}
+
+void Node::_child_index_remove(Node *p_child, const StringName &p_name) {
+
+	if (!data.child_index)
+		return;
+
+	if (data.child_index_collisions || data.children.size() < CHILD_INDEX_THRESHOLD / 2) {
+		// another child may share the name, or the index no longer pays off; rebuild on demand
+		_clear_child_index();
+		return;
+	}
+
+	Node **child = data.child_index->getptr(p_name);
+	if (child && *child == p_child)
+		data.child_index->erase(p_name);
+}
+
 Node *Node::_get_child_by_name(const StringName &p_name) const {
 
 	int cc = data.children.size();
+
+	if (cc > CHILD_INDEX_THRESHOLD) {
+
+		if (!data.child_index)
+			_build_child_index();
+
+		Node *const *child = data.child_index->getptr(p_name);
+		return child ? *child : NULL;
+	}
+
 	Node *const *cd = data.children.ptr();
 
 	for (int i = 0; i < cc; i++) {
@@ -918,18 +1083,7 @@ Node *Node::_get_node(const NodePath &p_path) const {
 
 		} else {
 
-			next = NULL;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == NULL) {
 				return NULL;
 			};
@@ -1000,63 +1154,141 @@ bool Node::is_greater_than(const Node *p_node) const {
 	ERR_FAIL_COND_V(!data.inside_tree, false);
 	ERR_FAIL_COND_V(!p_node->data.inside_tree, false);
 
-	ERR_FAIL_COND_V(data.depth < 0, false);
-	ERR_FAIL_COND_V(p_node->data.depth < 0, false);
-#ifdef NO_ALLOCA
+	return data.order > p_node->data.order;
+}
 
-	Vector<int> this_stack;
-	Vector<int> that_stack;
-	this_stack.resize(data.depth);
-	that_stack.resize(p_node->data.depth);
+/* Tree order labels (Dietz-Sleator order maintenance).
+ *
+ * Every node inside the tree is linked into a list following a preorder walk
+ * of the tree, and carries a label that grows along that list. Comparing two
+ * nodes in tree order is then a single integer comparison. Labels are only
+ * renumbered locally when an insertion finds no free label left. */
 
-#else
+#define ORDER_LABEL_MAX 0xFFFFFFFFFFFFFFFFULL
+#define ORDER_LABEL_SPACING 0x100000000ULL
 
-	int *this_stack = (int *)alloca(sizeof(int) * data.depth);
-	int *that_stack = (int *)alloca(sizeof(int) * p_node->data.depth);
+Node *Node::_order_get_prev() const {
 
-#endif
+	if (!data.parent)
+		return NULL;
 
-	const Node *n = this;
+	// the preorder predecessor is the last descendant (inside the tree) of the previous sibling, or the parent itself
+	for (int i = data.pos - 1; i >= 0; i--) {
 
-	int idx = data.depth - 1;
-	while (n) {
-		ERR_FAIL_INDEX_V(idx, data.depth, false);
-		this_stack[idx--] = n->data.pos;
-		n = n->data.parent;
+		Node *n = data.parent->data.children[i];
+		if (!n->data.inside_tree || n == this)
+			continue;
+
+		while (true) {
+
+			Node *last = NULL;
+			for (int j = n->data.children.size() - 1; j >= 0; j--) {
+				if (n->data.children[j]->data.inside_tree) {
+					last = n->data.children[j];
+					break;
+				}
+			}
+			if (!last)
+				return n;
+			n = last;
+		}
 	}
-	ERR_FAIL_COND_V(idx != -1, false);
-	n = p_node;
-	idx = p_node->data.depth - 1;
-	while (n) {
-		ERR_FAIL_INDEX_V(idx, p_node->data.depth, false);
-		that_stack[idx--] = n->data.pos;
 
-		n = n->data.parent;
+	return data.parent;
+}
+
+void Node::_order_relabel(Node *p_base) {
+
+	// find the smallest j whose label distance from the base exceeds j^2, then spread the j - 1 nodes in between evenly
+	uint64_t base = p_base->data.order;
+	uint64_t j = 1;
+	Node *n = p_base->data.order_next;
+	while (n && n->data.order - base <= j * j) {
+		n = n->data.order_next;
+		j++;
 	}
-	ERR_FAIL_COND_V(idx != -1, false);
-	idx = 0;
 
-	bool res;
-	while (true) {
+	uint64_t range = n ? n->data.order - base : ORDER_LABEL_MAX - base;
 
-		// using -2 since out-of-tree or nonroot nodes have -1
-		int this_idx = (idx >= data.depth) ? -2 : this_stack[idx];
-		int that_idx = (idx >= p_node->data.depth) ? -2 : that_stack[idx];
+	if (range <= j * j) {
+		// the end of the label space is crowded, renumber the whole list
+		Node *head = p_base;
+		uint64_t count = 0;
+		while (head->data.order_prev)
+			head = head->data.order_prev;
+		for (Node *E = head; E; E = E->data.order_next)
+			count++;
 
-		if (this_idx > that_idx) {
-			res = true;
-			break;
-		} else if (this_idx < that_idx) {
-			res = false;
-			break;
-		} else if (this_idx == -2) {
-			res = false; // equal
-			break;
+		uint64_t step = ORDER_LABEL_MAX / (count + 1);
+		uint64_t label = 0;
+		for (Node *E = head; E; E = E->data.order_next) {
+			E->data.order = label;
+			label += step;
 		}
-		idx++;
+		return;
+	}
+
+	uint64_t step = range / j;
+	uint64_t label = base + step;
+	for (Node *E = p_base->data.order_next; E != n; E = E->data.order_next) {
+		E->data.order = label;
+		label += step;
+	}
+}
+
+void Node::_order_insert_after(Node *p_prev) {
+
+	data.order_prev = p_prev;
+	data.order_next = NULL;
+
+	if (!p_prev) {
+		// root of the tree, nothing comes before it
+		data.order = 0;
+		return;
 	}
 
-	return res;
+	uint64_t limit = p_prev->data.order_next ? p_prev->data.order_next->data.order : ORDER_LABEL_MAX;
+	if (limit - p_prev->data.order < 2) {
+		_order_relabel(p_prev);
+		limit = p_prev->data.order_next ? p_prev->data.order_next->data.order : ORDER_LABEL_MAX;
+	}
+
+	data.order = p_prev->data.order + MIN((limit - p_prev->data.order) / 2, ORDER_LABEL_SPACING);
+
+	data.order_next = p_prev->data.order_next;
+	if (data.order_next)
+		data.order_next->data.order_prev = this;
+	p_prev->data.order_next = this;
+}
+
+void Node::_order_remove() {
+
+	if (data.order_prev)
+		data.order_prev->data.order_next = data.order_next;
+	if (data.order_next)
+		data.order_next->data.order_prev = data.order_prev;
+
+	data.order_prev = NULL;
+	data.order_next = NULL;
+}
+
+void Node::_order_remove_subtree() {
+
+	_order_remove();
+	for (int i = 0; i < data.children.size(); i++) {
+		if (data.children[i]->data.inside_tree)
+			data.children[i]->_order_remove_subtree();
+	}
+}
+
+void Node::_order_relink_subtree(Node *&r_prev) {
+
+	_order_insert_after(r_prev);
+	r_prev = this;
+	for (int i = 0; i < data.children.size(); i++) {
+		if (data.children[i]->data.inside_tree)
+			data.children[i]->_order_relink_subtree(r_prev);
+	}
 }
 
 void Node::get_owned_by(Node *p_by, List<Node *> *p_owned) {
@@ -2101,6 +2333,7 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_name", "name"), &Node::set_name);
 	ClassDB::bind_method(D_METHOD("get_name"), &Node::get_name);
 	ClassDB::bind_method(D_METHOD("add_child", "node", "legible_unique_name"), &Node::add_child, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_children", "nodes", "legible_unique_name"), &Node::add_children, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("remove_child", "node"), &Node::remove_child);
 	ClassDB::bind_method(D_METHOD("get_child_count"), &Node::get_child_count);
 	ClassDB::bind_method(D_METHOD("get_children"), &Node::_get_children);
@@ -2238,6 +2471,11 @@ Node::Node() {
 
 	data.pos = -1;
 	data.depth = -1;
+	data.order = 0;
+	data.order_prev = NULL;
+	data.order_next = NULL;
+	data.child_index = NULL;
+	data.child_index_collisions = false;
 	data.blocked = 0;
 	data.parent = NULL;
 	data.tree = NULL;
@@ -2268,6 +2506,7 @@ Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
+	_clear_child_index();
 
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
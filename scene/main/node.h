@@ -87,8 +87,14 @@ private:
 		Node *parent;
 		Node *owner;
 		Vector<Node *> children; // list of children
+		mutable OAHashMap<StringName, Node *, StringNameHasher> *child_index; // name lookup, built lazily for nodes with many children
+		mutable bool child_index_collisions;
 		int pos;
 		int depth;
+		// tree-order label, kept increasing along a preorder walk of the nodes inside the tree
+		uint64_t order;
+		Node *order_prev;
+		Node *order_next;
 		int blocked; // safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
 		StringName name;
 		SceneTree *tree;
@@ -138,7 +144,15 @@ private:
 	void _print_tree(const Node *p_node);
 
 	Node *_get_node(const NodePath &p_path) const;
+	enum {
+		CHILD_INDEX_THRESHOLD = 32 // children needed before lookups by name go through a hash index
+	};
+
 	Node *_get_child_by_name(const StringName &p_name) const;
+	void _build_child_index() const;
+	void _clear_child_index();
+	void _child_index_add(Node *p_child);
+	void _child_index_remove(Node *p_child, const StringName &p_name);
 
 	void _replace_connections_target(Node *p_new_target);
 
@@ -147,6 +161,12 @@ private:
 
 	void _propagate_reverse_notification(int p_notification);
 	void _propagate_deferred_notification(int p_notification, bool p_reverse);
+	Node *_order_get_prev() const;
+	void _order_insert_after(Node *p_prev);
+	void _order_remove();
+	void _order_remove_subtree();
+	void _order_relink_subtree(Node *&r_prev);
+	static void _order_relabel(Node *p_base);
 	void _propagate_enter_tree();
 	void _propagate_ready();
 	void _propagate_exit_tree();
@@ -214,6 +234,7 @@ public:
 	void set_name(const String &p_name);
 
 	void add_child(Node *p_child, bool p_legible_unique_name = false);
+	void add_children(const Array &p_children, bool p_legible_unique_name = false);
 	void add_child_below_node(Node *p_node, Node *p_child, bool p_legible_unique_name = false);
 	void remove_child(Node *p_child);
 
@@ -37,6 +37,7 @@
 #include "os/keyboard.h"
 #include "os/os.h"
 #include "print_string.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
@@ -430,6 +431,8 @@ void SceneTree::init() {
 
 bool SceneTree::iteration(float p_time) {
 
+	PROFILE_SCOPE("SceneTree::iteration");
+
 	root_lock++;
 
 	current_frame++;
@@ -457,6 +460,8 @@ bool SceneTree::iteration(float p_time) {
 
 bool SceneTree::idle(float p_time) {
 
+	PROFILE_SCOPE("SceneTree::idle");
+
 	//print_line("ram: "+itos(OS::get_singleton()->get_static_memory_usage())+" sram: "+itos(OS::get_singleton()->get_dynamic_memory_usage()));
 	//print_line("node count: "+itos(get_node_count()));
 	//print_line("TEXTURE RAM: "+itos(VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_USED)));
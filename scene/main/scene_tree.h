@@ -206,6 +206,7 @@ private:
 	Variant _call_group(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 
 	void _flush_delete_queue();
+
 	//optimization
 	friend class CanvasItem;
 	friend class Spatial;
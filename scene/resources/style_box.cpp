@@ -664,6 +664,25 @@ void StyleBoxFlat::draw(RID p_canvas_item, const Rect2 &p_rect) const {
 	adapt_values(CORNER_TOP_LEFT, CORNER_TOP_RIGHT, adapted_corner, corner_radius, width, width - adapted_border[MARGIN_RIGHT], width - adapted_border[MARGIN_LEFT]);
 	adapt_values(CORNER_BOTTOM_LEFT, CORNER_BOTTOM_RIGHT, adapted_corner, corner_radius, width, width - adapted_border[MARGIN_RIGHT], width - adapted_border[MARGIN_LEFT]);
 
+	VisualServer *vs = VisualServer::get_singleton();
+
+	//the common case is a single quad, the renderer evaluates the shape per pixel
+	PoolVector<Color>::Read border_colors = border_color.read();
+	bool single_border_color = border_colors[0] == border_colors[1] && border_colors[0] == border_colors[2] && border_colors[0] == border_colors[3];
+	if (!blend_border && single_border_color) {
+
+		Color center_color = draw_center ? bg_color : Color(bg_color.r, bg_color.g, bg_color.b, 0);
+		Color shadow = shadow_size > 0 ? shadow_color : Color(0, 0, 0, 0);
+		//without borders the anti-aliased edge must fade the center, not the unused border color
+		bool has_border = adapted_border[MARGIN_LEFT] > 0 || adapted_border[MARGIN_TOP] > 0 || adapted_border[MARGIN_RIGHT] > 0 || adapted_border[MARGIN_BOTTOM] > 0;
+		vs->canvas_item_add_style_rect(p_canvas_item, style_rect, center_color,
+				Vector2(adapted_border[MARGIN_LEFT], adapted_border[MARGIN_TOP]), Vector2(adapted_border[MARGIN_RIGHT], adapted_border[MARGIN_BOTTOM]), has_border ? border_colors[0] : center_color,
+				Vector2(adapted_corner[CORNER_TOP_LEFT], adapted_corner[CORNER_TOP_RIGHT]), Vector2(adapted_corner[CORNER_BOTTOM_LEFT], adapted_corner[CORNER_BOTTOM_RIGHT]),
+				shadow, MAX(shadow_size, 0), aa_on ? aa_size : 0);
+		return;
+	}
+
+	//per side colors and blended borders still go through triangles
 	Rect2 infill_rect = style_rect.grow_individual(-adapted_border[MARGIN_LEFT], -adapted_border[MARGIN_TOP], -adapted_border[MARGIN_RIGHT], -adapted_border[MARGIN_BOTTOM]);
 
 	Vector<Point2> verts;
@@ -671,7 +690,6 @@ void StyleBoxFlat::draw(RID p_canvas_item, const Rect2 &p_rect) const {
 	Vector<Color> colors;
 
 	//DRAWING
-	VisualServer *vs = VisualServer::get_singleton();
 
 	//DRAW SHADOW
 	if (shadow_size > 0) {
@@ -257,6 +257,14 @@ void Theme::set_default_font(const Ref<Font> &p_font) {
 	default_font = p_font;
 }
 
+// Two lookups instead of the has()/operator[] chains, theme items are queried on every draw.
+template <class T>
+static _FORCE_INLINE_ const T *_get_theme_item(const HashMap<StringName, OAHashMap<StringName, T, StringNameHasher>, StringNameHasher> &p_map, const StringName &p_name, const StringName &p_type) {
+
+	const OAHashMap<StringName, T, StringNameHasher> *type_map = p_map.getptr(p_type);
+	return type_map ? type_map->getptr(p_name) : NULL;
+}
+
 void Theme::set_icon(const StringName &p_name, const StringName &p_type, const Ref<Texture> &p_icon) {
 
 	//ERR_FAIL_COND(p_icon.is_null());
@@ -272,9 +280,10 @@ void Theme::set_icon(const StringName &p_name, const StringName &p_type, const R
 }
 Ref<Texture> Theme::get_icon(const StringName &p_name, const StringName &p_type) const {
 
-	if (icon_map.has(p_type) && icon_map[p_type].has(p_name) && icon_map[p_type][p_name].is_valid()) {
+	const Ref<Texture> *icon = _get_theme_item(icon_map, p_name, p_type);
+	if (icon && icon->is_valid()) {
 
-		return icon_map[p_type][p_name];
+		return *icon;
 	} else {
 		return default_icon;
 	}
@@ -282,7 +291,8 @@ Ref<Texture> Theme::get_icon(const StringName &p_name, const StringName &p_type)
 
 bool Theme::has_icon(const StringName &p_name, const StringName &p_type) const {
 
-	return (icon_map.has(p_type) && icon_map[p_type].has(p_name) && icon_map[p_type][p_name].is_valid());
+	const Ref<Texture> *icon = _get_theme_item(icon_map, p_name, p_type);
+	return icon && icon->is_valid();
 }
 
 void Theme::clear_icon(const StringName &p_name, const StringName &p_type) {
@@ -320,15 +330,17 @@ void Theme::set_shader(const StringName &p_name, const StringName &p_type, const
 }
 
 Ref<Shader> Theme::get_shader(const StringName &p_name, const StringName &p_type) const {
-	if (shader_map.has(p_type) && shader_map[p_type].has(p_name) && shader_map[p_type][p_name].is_valid()) {
-		return shader_map[p_type][p_name];
+	const Ref<Shader> *shader = _get_theme_item(shader_map, p_name, p_type);
+	if (shader && shader->is_valid()) {
+		return *shader;
 	} else {
 		return NULL;
 	}
 }
 
 bool Theme::has_shader(const StringName &p_name, const StringName &p_type) const {
-	return (shader_map.has(p_type) && shader_map[p_type].has(p_name) && shader_map[p_type][p_name].is_valid());
+	const Ref<Shader> *shader = _get_theme_item(shader_map, p_name, p_type);
+	return shader && shader->is_valid();
 }
 
 void Theme::clear_shader(const StringName &p_name, const StringName &p_type) {
@@ -367,9 +379,10 @@ void Theme::set_stylebox(const StringName &p_name, const StringName &p_type, con
 
 Ref<StyleBox> Theme::get_stylebox(const StringName &p_name, const StringName &p_type) const {
 
-	if (style_map.has(p_type) && style_map[p_type].has(p_name) && style_map[p_type][p_name].is_valid()) {
+	const Ref<StyleBox> *style = _get_theme_item(style_map, p_name, p_type);
+	if (style && style->is_valid()) {
 
-		return style_map[p_type][p_name];
+		return *style;
 	} else {
 		return default_style;
 	}
@@ -377,7 +390,8 @@ Ref<StyleBox> Theme::get_stylebox(const StringName &p_name, const StringName &p_
 
 bool Theme::has_stylebox(const StringName &p_name, const StringName &p_type) const {
 
-	return (style_map.has(p_type) && style_map[p_type].has(p_name) && style_map[p_type][p_name].is_valid());
+	const Ref<StyleBox> *style = _get_theme_item(style_map, p_name, p_type);
+	return style && style->is_valid();
 }
 
 void Theme::clear_stylebox(const StringName &p_name, const StringName &p_type) {
@@ -434,8 +448,9 @@ void Theme::set_font(const StringName &p_name, const StringName &p_type, const R
 }
 Ref<Font> Theme::get_font(const StringName &p_name, const StringName &p_type) const {
 
-	if (font_map.has(p_type) && font_map[p_type].has(p_name) && font_map[p_type][p_name].is_valid())
-		return font_map[p_type][p_name];
+	const Ref<Font> *font = _get_theme_item(font_map, p_name, p_type);
+	if (font && font->is_valid())
+		return *font;
 	else if (default_theme_font.is_valid())
 		return default_theme_font;
 	else
@@ -444,7 +459,8 @@ Ref<Font> Theme::get_font(const StringName &p_name, const StringName &p_type) co
 
 bool Theme::has_font(const StringName &p_name, const StringName &p_type) const {
 
-	return (font_map.has(p_type) && font_map[p_type].has(p_name) && font_map[p_type][p_name].is_valid());
+	const Ref<Font> *font = _get_theme_item(font_map, p_name, p_type);
+	return font && font->is_valid();
 }
 
 void Theme::clear_font(const StringName &p_name, const StringName &p_type) {
@@ -488,15 +504,16 @@ void Theme::set_color(const StringName &p_name, const StringName &p_type, const
 
 Color Theme::get_color(const StringName &p_name, const StringName &p_type) const {
 
-	if (color_map.has(p_type) && color_map[p_type].has(p_name))
-		return color_map[p_type][p_name];
+	const Color *color = _get_theme_item(color_map, p_name, p_type);
+	if (color)
+		return *color;
 	else
 		return Color();
 }
 
 bool Theme::has_color(const StringName &p_name, const StringName &p_type) const {
 
-	return (color_map.has(p_type) && color_map[p_type].has(p_name));
+	return _get_theme_item(color_map, p_name, p_type) != NULL;
 }
 
 void Theme::clear_color(const StringName &p_name, const StringName &p_type) {
@@ -535,8 +552,9 @@ void Theme::set_constant(const StringName &p_name, const StringName &p_type, int
 
 int Theme::get_constant(const StringName &p_name, const StringName &p_type) const {
 
-	if (constant_map.has(p_type) && constant_map[p_type].has(p_name))
-		return constant_map[p_type][p_name];
+	const int *constant = _get_theme_item(constant_map, p_name, p_type);
+	if (constant)
+		return *constant;
 	else {
 		return 0;
 	}
@@ -544,7 +562,7 @@ int Theme::get_constant(const StringName &p_name, const StringName &p_type) cons
 
 bool Theme::has_constant(const StringName &p_name, const StringName &p_type) const {
 
-	return (constant_map.has(p_type) && constant_map[p_type].has(p_name));
+	return _get_theme_item(constant_map, p_name, p_type) != NULL;
 }
 
 void Theme::clear_constant(const StringName &p_name, const StringName &p_type) {
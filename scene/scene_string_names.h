@@ -93,6 +93,7 @@ public:
 	StringName animation_finished;
 	StringName animation_changed;
 	StringName animation_started;
+	StringName tween_step;
 
 	StringName body_shape_entered;
 	StringName body_entered;
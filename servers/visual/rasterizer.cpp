@@ -42,6 +42,8 @@ Rasterizer *Rasterizer::create() {
 
 RasterizerStorage *RasterizerStorage::base_singleton = NULL;
 
+uint32_t RasterizerCanvas::command_allocations = 0;
+
 RasterizerStorage::RasterizerStorage() {
 
 	base_singleton = this;
@@ -32,8 +32,10 @@
 #define RASTERIZER_H
 
 #include "camera_matrix.h"
+#include "hashfuncs.h"
 #include "servers/visual_server.h"
 
+#include "safe_refcount.h"
 #include "self_list.h"
 
 class RasterizerScene {
@@ -565,6 +567,9 @@ public:
 		CANVAS_RECT_CLIP_UV = 32
 	};
 
+	// Heap allocations done to store canvas item commands, reset every frame.
+	static uint32_t command_allocations;
+
 	struct Light : public RID_Data {
 
 		bool enabled;
@@ -645,6 +650,7 @@ public:
 				TYPE_POLYLINE,
 				TYPE_RECT,
 				TYPE_NINEPATCH,
+				TYPE_STYLE_RECT,
 				TYPE_PRIMITIVE,
 				TYPE_POLYGON,
 				TYPE_MESH,
@@ -714,6 +720,27 @@ public:
 			}
 		};
 
+		struct CommandStyleRect : public Command {
+
+			Rect2 rect;
+			Color color;
+			Color border_color;
+			Color shadow_color;
+			float border[4];
+			float corner_radius[4];
+			float shadow_size;
+			float aa_size;
+
+			// area actually touched, including the shadow and the fading edge
+			Rect2 get_draw_rect() const { return rect.grow(shadow_size + aa_size); }
+
+			CommandStyleRect() {
+				type = TYPE_STYLE_RECT;
+				shadow_size = 0;
+				aa_size = 0;
+			}
+		};
+
 		struct CommandPrimitive : public Command {
 
 			Vector<Point2> points;
@@ -801,13 +828,118 @@ public:
 			Rect2 rect;
 		};
 
+		// Works like Vector<Command *> for the renderer, but keeps its buffer
+		// when cleared since items are re-recorded on every redraw.
+		struct CommandList {
+
+			Command **data;
+			int count;
+			int capacity;
+
+			_FORCE_INLINE_ int size() const { return count; }
+			_FORCE_INLINE_ bool empty() const { return count == 0; }
+			_FORCE_INLINE_ Command **ptrw() { return data; }
+			_FORCE_INLINE_ Command *const &operator[](int p_index) const { return data[p_index]; }
+
+			void push_back(Command *p_command) {
+				if (count == capacity) {
+					capacity = capacity ? capacity * 2 : 8;
+					data = (Command **)memrealloc(data, capacity * sizeof(Command *));
+					atomic_increment(&command_allocations);
+				}
+				data[count++] = p_command;
+			}
+
+			void clear() { count = 0; }
+
+			CommandList() {
+				data = NULL;
+				count = 0;
+				capacity = 0;
+			}
+			~CommandList() {
+				if (data)
+					memfree(data);
+			}
+		};
+
+		// Commands are constructed in blocks owned by the item instead of
+		// being allocated one by one. Clearing only rewinds the blocks, and if
+		// a redraw needed more than one, they are merged into a single block
+		// the next time around.
+		struct CommandBlock {
+
+			CommandBlock *next;
+			uint32_t capacity;
+			uint32_t used;
+
+			_FORCE_INLINE_ uint8_t *get_data() { return ((uint8_t *)this) + HEADER_SIZE; }
+
+			enum {
+				HEADER_SIZE = (sizeof(void *) + sizeof(uint32_t) * 2 + 15) & ~15,
+				MIN_CAPACITY = 512
+			};
+		};
+
+		CommandBlock *command_blocks;
+		CommandBlock *command_block_last;
+		uint32_t command_block_reserve;
+
+		void *_alloc_command_memory(uint32_t p_size) {
+
+			p_size = (p_size + 15) & ~15;
+
+			CommandBlock *block = command_block_last;
+			if (!block || block->capacity - block->used < p_size) {
+
+				uint32_t capacity = block ? block->capacity * 2 : MAX(command_block_reserve, (uint32_t)CommandBlock::MIN_CAPACITY);
+				capacity = MAX(capacity, p_size);
+
+				block = (CommandBlock *)memalloc(CommandBlock::HEADER_SIZE + capacity);
+				block->next = NULL;
+				block->capacity = capacity;
+				block->used = 0;
+				atomic_increment(&command_allocations);
+
+				if (command_block_last) {
+					command_block_last->next = block;
+				} else {
+					command_blocks = block;
+				}
+				command_block_last = block;
+			}
+
+			void *mem = block->get_data() + block->used;
+			block->used += p_size;
+			return mem;
+		}
+
+		void _free_command_blocks() {
+
+			while (command_blocks) {
+				CommandBlock *next = command_blocks->next;
+				memfree(command_blocks);
+				command_blocks = next;
+			}
+			command_block_last = NULL;
+		}
+
+		template <class T>
+		_FORCE_INLINE_ T *alloc_command() {
+
+			T *command = memnew_placement(_alloc_command_memory(sizeof(T)), T);
+			commands.push_back(command);
+			command_hash_valid = false;
+			return command;
+		}
+
 		Transform2D xform;
 		bool clip;
 		bool visible;
 		bool behind;
 		//VS::MaterialBlendMode blend_mode;
 		int light_mask;
-		Vector<Command *> commands;
+		CommandList commands;
 		mutable bool custom_rect;
 		mutable bool rect_dirty;
 		mutable Rect2 rect;
@@ -832,6 +964,9 @@ public:
 
 		Rect2 global_rect_cache;
 
+		uint64_t command_hash; // see hash_commands(), when command_hash_valid
+		bool command_hash_valid;
+
 		const Rect2 &get_rect() const {
 			if (custom_rect || !rect_dirty)
 				return rect;
@@ -899,6 +1034,11 @@ public:
 						const Item::CommandNinePatch *style = static_cast<const Item::CommandNinePatch *>(c);
 						r = style->rect;
 					} break;
+					case Item::Command::TYPE_STYLE_RECT: {
+
+						const Item::CommandStyleRect *style = static_cast<const Item::CommandStyleRect *>(c);
+						r = style->get_draw_rect();
+					} break;
 					case Item::Command::TYPE_PRIMITIVE: {
 
 						const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(c);
@@ -979,10 +1119,180 @@ public:
 			return rect;
 		}
 
+		// 64-bit FNV-1a. djb2 is linear, so small opposite changes in
+		// neighbouring bytes (two coordinates, two color channels) cancel out.
+		static _FORCE_INLINE_ uint64_t _hash_bytes(const uint8_t *p_bytes, int p_len, uint64_t p_hash) {
+			for (int i = 0; i < p_len; i++) {
+				p_hash ^= p_bytes[i];
+				p_hash *= 0x100000001b3ULL;
+			}
+			return p_hash;
+		}
+
+		template <class T>
+		static _FORCE_INLINE_ uint64_t _hash_value(const T &p_value, uint64_t p_hash) {
+			return _hash_bytes((const uint8_t *)&p_value, sizeof(T), p_hash);
+		}
+
+		template <class T>
+		static _FORCE_INLINE_ uint64_t _hash_vector(const Vector<T> &p_vector, uint64_t p_hash) {
+			p_hash = _hash_value(p_vector.size(), p_hash);
+			return _hash_bytes((const uint8_t *)p_vector.ptr(), p_vector.size() * sizeof(T), p_hash);
+		}
+
+		static _FORCE_INLINE_ uint64_t _hash_rid(const RID &p_rid, uint64_t p_hash) {
+			return _hash_value(p_rid.get_id(), p_hash);
+		}
+
+		// Hash of everything the commands draw, used to tell whether a redraw
+		// produced the same stream as the previous one.
+		uint64_t hash_commands() const {
+
+			uint64_t h = _hash_value(commands.size(), 0xcbf29ce484222325ULL);
+
+			for (int i = 0; i < commands.size(); i++) {
+
+				const Item::Command *c = commands[i];
+				h = _hash_value(c->type, h);
+
+				switch (c->type) {
+					case Item::Command::TYPE_LINE: {
+
+						const Item::CommandLine *line = static_cast<const Item::CommandLine *>(c);
+						h = _hash_value(line->from, h);
+						h = _hash_value(line->to, h);
+						h = _hash_value(line->color, h);
+						h = _hash_value(line->width, h);
+						h = _hash_value(line->antialiased, h);
+					} break;
+					case Item::Command::TYPE_POLYLINE: {
+
+						const Item::CommandPolyLine *pline = static_cast<const Item::CommandPolyLine *>(c);
+						h = _hash_value(pline->antialiased, h);
+						h = _hash_value(pline->multiline, h);
+						h = _hash_vector(pline->triangles, h);
+						h = _hash_vector(pline->triangle_colors, h);
+						h = _hash_vector(pline->lines, h);
+						h = _hash_vector(pline->line_colors, h);
+					} break;
+					case Item::Command::TYPE_RECT: {
+
+						const Item::CommandRect *crect = static_cast<const Item::CommandRect *>(c);
+						h = _hash_value(crect->rect, h);
+						h = _hash_rid(crect->texture, h);
+						h = _hash_rid(crect->normal_map, h);
+						h = _hash_value(crect->modulate, h);
+						h = _hash_value(crect->source, h);
+						h = _hash_value(crect->flags, h);
+					} break;
+					case Item::Command::TYPE_NINEPATCH: {
+
+						const Item::CommandNinePatch *style = static_cast<const Item::CommandNinePatch *>(c);
+						h = _hash_value(style->rect, h);
+						h = _hash_value(style->source, h);
+						h = _hash_rid(style->texture, h);
+						h = _hash_rid(style->normal_map, h);
+						h = _hash_value(style->margin, h);
+						h = _hash_value(style->draw_center, h);
+						h = _hash_value(style->color, h);
+						h = _hash_value(style->axis_x, h);
+						h = _hash_value(style->axis_y, h);
+					} break;
+					case Item::Command::TYPE_STYLE_RECT: {
+
+						const Item::CommandStyleRect *style = static_cast<const Item::CommandStyleRect *>(c);
+						h = _hash_value(style->rect, h);
+						h = _hash_value(style->color, h);
+						h = _hash_value(style->border_color, h);
+						h = _hash_value(style->shadow_color, h);
+						h = _hash_value(style->border, h);
+						h = _hash_value(style->corner_radius, h);
+						h = _hash_value(style->shadow_size, h);
+						h = _hash_value(style->aa_size, h);
+					} break;
+					case Item::Command::TYPE_PRIMITIVE: {
+
+						const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(c);
+						h = _hash_vector(primitive->points, h);
+						h = _hash_vector(primitive->uvs, h);
+						h = _hash_vector(primitive->colors, h);
+						h = _hash_rid(primitive->texture, h);
+						h = _hash_rid(primitive->normal_map, h);
+						h = _hash_value(primitive->width, h);
+					} break;
+					case Item::Command::TYPE_POLYGON: {
+
+						const Item::CommandPolygon *polygon = static_cast<const Item::CommandPolygon *>(c);
+						h = _hash_vector(polygon->indices, h);
+						h = _hash_vector(polygon->points, h);
+						h = _hash_vector(polygon->uvs, h);
+						h = _hash_vector(polygon->colors, h);
+						h = _hash_rid(polygon->texture, h);
+						h = _hash_rid(polygon->normal_map, h);
+						h = _hash_value(polygon->count, h);
+						h = _hash_value(polygon->antialiased, h);
+					} break;
+					case Item::Command::TYPE_MESH: {
+
+						const Item::CommandMesh *mesh = static_cast<const Item::CommandMesh *>(c);
+						h = _hash_rid(mesh->mesh, h);
+						h = _hash_rid(mesh->texture, h);
+						h = _hash_rid(mesh->normal_map, h);
+					} break;
+					case Item::Command::TYPE_MULTIMESH: {
+
+						const Item::CommandMultiMesh *multimesh = static_cast<const Item::CommandMultiMesh *>(c);
+						h = _hash_rid(multimesh->multimesh, h);
+						h = _hash_rid(multimesh->texture, h);
+						h = _hash_rid(multimesh->normal_map, h);
+					} break;
+					case Item::Command::TYPE_PARTICLES: {
+
+						const Item::CommandParticles *particles_cmd = static_cast<const Item::CommandParticles *>(c);
+						h = _hash_rid(particles_cmd->particles, h);
+						h = _hash_rid(particles_cmd->texture, h);
+						h = _hash_rid(particles_cmd->normal_map, h);
+						h = _hash_value(particles_cmd->h_frames, h);
+						h = _hash_value(particles_cmd->v_frames, h);
+					} break;
+					case Item::Command::TYPE_CIRCLE: {
+
+						const Item::CommandCircle *circle = static_cast<const Item::CommandCircle *>(c);
+						h = _hash_value(circle->pos, h);
+						h = _hash_value(circle->radius, h);
+						h = _hash_value(circle->color, h);
+					} break;
+					case Item::Command::TYPE_TRANSFORM: {
+
+						const Item::CommandTransform *transform = static_cast<const Item::CommandTransform *>(c);
+						h = _hash_value(transform->xform, h);
+					} break;
+					case Item::Command::TYPE_CLIP_IGNORE: {
+
+						const Item::CommandClipIgnore *ci = static_cast<const Item::CommandClipIgnore *>(c);
+						h = _hash_value(ci->ignore, h);
+					} break;
+				}
+			}
+
+			return h;
+		}
+
 		void clear() {
 			for (int i = 0; i < commands.size(); i++)
-				memdelete(commands[i]);
+				commands[i]->~Command();
 			commands.clear();
+			command_hash_valid = false;
+
+			if (command_blocks && command_blocks->next) {
+				command_block_reserve = 0;
+				for (CommandBlock *block = command_blocks; block; block = block->next) {
+					command_block_reserve += block->capacity;
+				}
+				_free_command_blocks();
+			} else if (command_blocks) {
+				command_blocks->used = 0;
+			}
 			clip = false;
 			rect_dirty = true;
 			final_clip_owner = NULL;
@@ -1004,9 +1314,15 @@ public:
 			copy_back_buffer = NULL;
 			distance_field = false;
 			light_masked = false;
+			command_blocks = NULL;
+			command_block_last = NULL;
+			command_block_reserve = 0;
+			command_hash = 0;
+			command_hash_valid = false;
 		}
 		virtual ~Item() {
 			clear();
+			_free_command_blocks();
 			if (copy_back_buffer) memdelete(copy_back_buffer);
 		}
 	};
@@ -29,6 +29,8 @@
 /*************************************************************************/
 
 #include "visual_server_canvas.h"
+#include "os/os.h"
+#include "profiler.h"
 #include "visual_server_global.h"
 #include "visual_server_viewport.h"
 
@@ -174,6 +176,8 @@ void VisualServerCanvas::_light_mask_canvas_items(int p_z, RasterizerCanvas::Ite
 
 void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect) {
 
+	PROFILE_SCOPE("VisualServerCanvas::render_canvas");
+
 	VSG::canvas_render->canvas_begin();
 
 	if (p_canvas->children_order_dirty) {
@@ -343,6 +347,11 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	if (canvas_item->xform_anim.active) {
+		canvas_item->xform_anim_to = p_transform; // retarget, the animation keeps running
+		return;
+	}
+
 	canvas_item->xform = p_transform;
 }
 void VisualServerCanvas::canvas_item_set_clip(RID p_item, bool p_clip) {
@@ -372,6 +381,11 @@ void VisualServerCanvas::canvas_item_set_modulate(RID p_item, const Color &p_col
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	if (canvas_item->modulate_anim.active) {
+		canvas_item->modulate_anim_to = p_color; // retarget, the animation keeps running
+		return;
+	}
+
 	canvas_item->modulate = p_color;
 }
 void VisualServerCanvas::canvas_item_set_self_modulate(RID p_item, const Color &p_color) {
@@ -395,7 +409,7 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandLine *line = memnew(Item::CommandLine);
+	Item::CommandLine *line = canvas_item->alloc_command<Item::CommandLine>();
 	ERR_FAIL_COND(!line);
 	line->color = p_color;
 	line->from = p_from;
@@ -403,8 +417,6 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 	line->width = p_width;
 	line->antialiased = p_antialiased;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(line);
 }
 
 void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, float p_width, bool p_antialiased) {
@@ -413,7 +425,7 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPolyLine *pline = memnew(Item::CommandPolyLine);
+	Item::CommandPolyLine *pline = canvas_item->alloc_command<Item::CommandPolyLine>();
 	ERR_FAIL_COND(!pline);
 
 	pline->antialiased = p_antialiased;
@@ -485,7 +497,6 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 		}
 	}
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(pline);
 }
 
 void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, float p_width, bool p_antialiased) {
@@ -494,7 +505,7 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPolyLine *pline = memnew(Item::CommandPolyLine);
+	Item::CommandPolyLine *pline = canvas_item->alloc_command<Item::CommandPolyLine>();
 	ERR_FAIL_COND(!pline);
 
 	pline->antialiased = false; //todo
@@ -509,7 +520,6 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	}
 
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(pline);
 }
 
 void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color) {
@@ -517,13 +527,11 @@ void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_color;
 	rect->rect = p_rect;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(rect);
 }
 
 void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color) {
@@ -531,13 +539,11 @@ void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandCircle *circle = memnew(Item::CommandCircle);
+	Item::CommandCircle *circle = canvas_item->alloc_command<Item::CommandCircle>();
 	ERR_FAIL_COND(!circle);
 	circle->color = p_color;
 	circle->pos = p_pos;
 	circle->radius = p_radius;
-
-	canvas_item->commands.push_back(circle);
 }
 
 void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose, RID p_normal_map) {
@@ -545,7 +551,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_modulate;
 	rect->rect = p_rect;
@@ -573,7 +579,6 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 	rect->texture = p_texture;
 	rect->normal_map = p_normal_map;
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(rect);
 }
 
 void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, RID p_normal_map, bool p_clip_uv) {
@@ -581,7 +586,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_modulate;
 	rect->rect = p_rect;
@@ -610,8 +615,6 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	}
 
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(rect);
 }
 
 void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, VS::NinePatchAxisMode p_x_axis_mode, VS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate, RID p_normal_map) {
@@ -619,7 +622,7 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandNinePatch *style = memnew(Item::CommandNinePatch);
+	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
 	style->texture = p_texture;
 	style->normal_map = p_normal_map;
@@ -634,15 +637,36 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 	style->axis_x = p_x_axis_mode;
 	style->axis_y = p_y_axis_mode;
 	canvas_item->rect_dirty = true;
+}
+void VisualServerCanvas::canvas_item_add_style_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, const Vector2 &p_border_topleft, const Vector2 &p_border_bottomright, const Color &p_border_color, const Vector2 &p_corner_radius_top, const Vector2 &p_corner_radius_bottom, const Color &p_shadow_color, float p_shadow_size, float p_aa_size) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
 
-	canvas_item->commands.push_back(style);
+	Item::CommandStyleRect *style = canvas_item->alloc_command<Item::CommandStyleRect>();
+	ERR_FAIL_COND(!style);
+	style->rect = p_rect;
+	style->color = p_color;
+	style->border_color = p_border_color;
+	style->shadow_color = p_shadow_color;
+	style->border[MARGIN_LEFT] = MAX(p_border_topleft.x, 0);
+	style->border[MARGIN_TOP] = MAX(p_border_topleft.y, 0);
+	style->border[MARGIN_RIGHT] = MAX(p_border_bottomright.x, 0);
+	style->border[MARGIN_BOTTOM] = MAX(p_border_bottomright.y, 0);
+	style->corner_radius[CORNER_TOP_LEFT] = MAX(p_corner_radius_top.x, 0);
+	style->corner_radius[CORNER_TOP_RIGHT] = MAX(p_corner_radius_top.y, 0);
+	style->corner_radius[CORNER_BOTTOM_RIGHT] = MAX(p_corner_radius_bottom.y, 0);
+	style->corner_radius[CORNER_BOTTOM_LEFT] = MAX(p_corner_radius_bottom.x, 0);
+	style->shadow_size = MAX(p_shadow_size, 0);
+	style->aa_size = MAX(p_aa_size, 0);
+	canvas_item->rect_dirty = true;
 }
 void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, float p_width, RID p_normal_map) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPrimitive *prim = memnew(Item::CommandPrimitive);
+	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
 	prim->texture = p_texture;
 	prim->normal_map = p_normal_map;
@@ -651,8 +675,55 @@ void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Poin
 	prim->colors = p_colors;
 	prim->width = p_width;
 	canvas_item->rect_dirty = true;
+}
+
+Vector<int> VisualServerCanvas::_triangulate_polygon(const Vector<Point2> &p_points) {
+
+	int point_count = p_points.size();
+	uint32_t hash = hash_djb2_buffer((const uint8_t *)p_points.ptr(), point_count * sizeof(Point2), hash_djb2_one_32(point_count));
+
+	triangulation_cache_mutex->lock();
+
+	for (int i = 0; i < 2; i++) {
+
+		int generation = (triangulation_cache_current + i) % 2;
+		TriangulationCache *cached = triangulation_cache[generation].getptr(hash);
+		if (!cached || cached->points.size() != point_count)
+			continue;
+		if (cached->points.ptr() != p_points.ptr() && memcmp(cached->points.ptr(), p_points.ptr(), point_count * sizeof(Point2)) != 0)
+			continue;
 
-	canvas_item->commands.push_back(prim);
+		Vector<int> indices = cached->indices;
+		if (generation != triangulation_cache_current) {
+			triangulation_cache[triangulation_cache_current].set(hash, *cached);
+			triangulation_cache[generation].erase(hash);
+		}
+
+		triangulation_cache_mutex->unlock();
+		return indices;
+	}
+
+	triangulation_cache_mutex->unlock();
+
+	Vector<int> indices = Geometry::triangulate_polygon(p_points);
+	if (indices.empty())
+		return indices;
+
+	TriangulationCache entry;
+	entry.points = p_points;
+	entry.indices = indices;
+
+	triangulation_cache_mutex->lock();
+
+	if (triangulation_cache[triangulation_cache_current].size() >= TRIANGULATION_CACHE_MAX) {
+		triangulation_cache_current = (triangulation_cache_current + 1) % 2;
+		triangulation_cache[triangulation_cache_current].clear();
+	}
+	triangulation_cache[triangulation_cache_current].set(hash, entry);
+
+	triangulation_cache_mutex->unlock();
+
+	return indices;
 }
 
 void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, RID p_normal_map, bool p_antialiased) {
@@ -667,7 +738,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 	ERR_FAIL_COND(color_size != 0 && color_size != 1 && color_size != pointcount);
 	ERR_FAIL_COND(uv_size != 0 && (uv_size != pointcount || !p_texture.is_valid()));
 #endif
-	Vector<int> indices = Geometry::triangulate_polygon(p_points);
+	Vector<int> indices = _triangulate_polygon(p_points);
 
 	if (indices.empty()) {
 
@@ -675,7 +746,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 		ERR_FAIL_V();
 	}
 
-	Item::CommandPolygon *polygon = memnew(Item::CommandPolygon);
+	Item::CommandPolygon *polygon = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture = p_texture;
 	polygon->normal_map = p_normal_map;
@@ -686,8 +757,6 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 	polygon->count = indices.size();
 	polygon->antialiased = p_antialiased;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(polygon);
 }
 
 void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, int p_count, RID p_normal_map) {
@@ -715,7 +784,7 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 			count = indices.size();
 	}
 
-	Item::CommandPolygon *polygon = memnew(Item::CommandPolygon);
+	Item::CommandPolygon *polygon = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture = p_texture;
 	polygon->normal_map = p_normal_map;
@@ -726,8 +795,6 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 	polygon->count = count;
 	polygon->antialiased = false;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(polygon);
 }
 
 void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
@@ -735,11 +802,9 @@ void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transfo
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandTransform *tr = memnew(Item::CommandTransform);
+	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
 	tr->xform = p_transform;
-
-	canvas_item->commands.push_back(tr);
 }
 
 void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, RID p_texture, RID p_normal_map) {
@@ -747,20 +812,18 @@ void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, RID
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandMesh *m = memnew(Item::CommandMesh);
+	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_COND(!m);
 	m->mesh = p_mesh;
 	m->texture = p_texture;
 	m->normal_map = p_normal_map;
-
-	canvas_item->commands.push_back(m);
 }
 void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture, RID p_normal, int p_h_frames, int p_v_frames) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandParticles *part = memnew(Item::CommandParticles);
+	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
 	part->particles = p_particles;
 	part->texture = p_texture;
@@ -772,7 +835,6 @@ void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles,
 	VSG::storage->particles_request_process(p_particles);
 
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(part);
 }
 
 void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture, RID p_normal_map) {
@@ -780,14 +842,13 @@ void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandMultiMesh *mm = memnew(Item::CommandMultiMesh);
+	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
 	mm->multimesh = p_mesh;
 	mm->texture = p_texture;
 	mm->normal_map = p_normal_map;
 
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(mm);
 }
 
 void VisualServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
@@ -795,11 +856,9 @@ void VisualServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandClipIgnore *ci = memnew(Item::CommandClipIgnore);
+	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
 	ci->ignore = p_ignore;
-
-	canvas_item->commands.push_back(ci);
 }
 void VisualServerCanvas::canvas_item_set_sort_children_by_y(RID p_item, bool p_enable) {
 
@@ -852,13 +911,147 @@ void VisualServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 	}
 }
 
-void VisualServerCanvas::canvas_item_clear(RID p_item) {
+static void _start_canvas_item_animation(VisualServerCanvas::Item::Animation &r_anim, float p_duration, float p_easing) {
+
+	r_anim.active = true;
+	r_anim.begin_usec = OS::get_singleton()->get_ticks_usec();
+	r_anim.duration_usec = uint64_t(MAX(p_duration, 0.0f) * 1000000.0);
+	r_anim.easing = p_easing;
+}
+
+void VisualServerCanvas::canvas_item_animate_transform(RID p_item, const Transform2D &p_from, const Transform2D &p_to, float p_duration, float p_easing) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	_start_canvas_item_animation(canvas_item->xform_anim, p_duration, p_easing);
+	canvas_item->xform_anim_from = p_from;
+	canvas_item->xform_anim_to = p_to;
+	canvas_item->xform = p_from;
+
+	if (!canvas_item->animation_list.in_list())
+		animated_items.add(&canvas_item->animation_list);
+}
+
+void VisualServerCanvas::canvas_item_animate_modulate(RID p_item, const Color &p_from, const Color &p_to, float p_duration, float p_easing) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	_start_canvas_item_animation(canvas_item->modulate_anim, p_duration, p_easing);
+	canvas_item->modulate_anim_from = p_from;
+	canvas_item->modulate_anim_to = p_to;
+	canvas_item->modulate = p_from;
+
+	if (!canvas_item->animation_list.in_list())
+		animated_items.add(&canvas_item->animation_list);
+}
+
+void VisualServerCanvas::canvas_item_stop_animations(RID p_item) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (canvas_item->xform_anim.active) {
+		canvas_item->xform = canvas_item->xform_anim_to;
+		canvas_item->xform_anim.active = false;
+	}
+	if (canvas_item->modulate_anim.active) {
+		canvas_item->modulate = canvas_item->modulate_anim_to;
+		canvas_item->modulate_anim.active = false;
+	}
+
+	if (canvas_item->animation_list.in_list())
+		animated_items.remove(&canvas_item->animation_list);
+}
+
+// returns the eased progress, or a negative value once the animation is over
+static float _step_canvas_item_animation(VisualServerCanvas::Item::Animation &r_anim, uint64_t p_now) {
+
+	uint64_t elapsed = p_now > r_anim.begin_usec ? p_now - r_anim.begin_usec : 0;
+	if (elapsed >= r_anim.duration_usec) {
+		r_anim.active = false;
+		return -1;
+	}
+
+	return Math::ease(double(elapsed) / double(r_anim.duration_usec), r_anim.easing);
+}
+
+bool VisualServerCanvas::update_animations() {
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	SelfList<Item> *E = animated_items.first();
+	while (E) {
+
+		SelfList<Item> *N = E->next();
+		Item *canvas_item = E->self();
+
+		if (canvas_item->xform_anim.active) {
+			float t = _step_canvas_item_animation(canvas_item->xform_anim, now);
+			canvas_item->xform = t < 0 ? canvas_item->xform_anim_to : canvas_item->xform_anim_from.interpolate_with(canvas_item->xform_anim_to, t);
+		}
+
+		if (canvas_item->modulate_anim.active) {
+			float t = _step_canvas_item_animation(canvas_item->modulate_anim, now);
+			canvas_item->modulate = t < 0 ? canvas_item->modulate_anim_to : canvas_item->modulate_anim_from.linear_interpolate(canvas_item->modulate_anim_to, t);
+		}
+
+		if (!canvas_item->xform_anim.active && !canvas_item->modulate_anim.active)
+			animated_items.remove(E);
+
+		E = N;
+	}
+
+	return animated_items.first() != NULL;
+}
+
+void VisualServerCanvas::canvas_item_clear(RID p_item, uint32_t p_changes, uint32_t p_frame) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	canvas_item->redrawing = true;
+	canvas_item->redraw_changes = p_changes;
+	canvas_item->redraw_frame = p_frame;
+	canvas_item->redraw_prev_hash_valid = canvas_item->command_hash_valid;
+	canvas_item->redraw_prev_hash = canvas_item->command_hash;
+	canvas_item->redraw_prev_rect_valid = !canvas_item->rect_dirty;
+	canvas_item->redraw_prev_rect = canvas_item->rect;
+
 	canvas_item->clear();
 }
+
+bool VisualServerCanvas::canvas_item_end_draw(RID p_item, int *r_command_count, uint32_t *r_changes, uint32_t *r_frame) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND_V(!canvas_item, true);
+
+	if (r_command_count)
+		*r_command_count = canvas_item->commands.size();
+	if (r_changes)
+		*r_changes = canvas_item->redraw_changes;
+	if (r_frame)
+		*r_frame = canvas_item->redraw_frame;
+
+	if (!canvas_item->redrawing)
+		return true; // not started by canvas_item_clear(), nothing to compare with
+
+	canvas_item->redrawing = false;
+	canvas_item->command_hash = canvas_item->hash_commands();
+	canvas_item->command_hash_valid = true;
+
+	if (!canvas_item->redraw_prev_hash_valid || canvas_item->redraw_prev_hash != canvas_item->command_hash)
+		return true;
+
+	// same commands as before, keep the bounds computed for them
+	if (canvas_item->redraw_prev_rect_valid && canvas_item->rect_dirty) {
+		canvas_item->rect = canvas_item->redraw_prev_rect;
+		canvas_item->rect_dirty = false;
+	}
+
+	return false;
+}
 void VisualServerCanvas::canvas_item_set_draw_index(RID p_item, int p_index) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -1364,4 +1557,12 @@ bool VisualServerCanvas::free(RID p_rid) {
 }
 
 VisualServerCanvas::VisualServerCanvas() {
+
+	triangulation_cache_current = 0;
+	triangulation_cache_mutex = Mutex::create();
+}
+
+VisualServerCanvas::~VisualServerCanvas() {
+
+	memdelete(triangulation_cache_mutex);
 }
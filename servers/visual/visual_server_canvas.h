@@ -53,7 +53,49 @@ public:
 
 		RID skeleton;
 
-		Item() {
+		// state from before canvas_item_clear(), to tell in
+		// canvas_item_end_draw() whether the redraw changed anything
+		bool redrawing;
+		bool redraw_prev_hash_valid;
+		uint64_t redraw_prev_hash;
+		bool redraw_prev_rect_valid;
+		Rect2 redraw_prev_rect;
+		uint32_t redraw_changes; // VisualServerRaster change counter at the clear
+		uint32_t redraw_frame; // and the frame it counted
+
+		// animations started with canvas_item_animate_*(), stepped by
+		// update_animations() on the thread that draws
+		struct Animation {
+
+			bool active;
+			uint64_t begin_usec;
+			uint64_t duration_usec;
+			float easing;
+
+			Animation() {
+				active = false;
+				begin_usec = 0;
+				duration_usec = 0;
+				easing = 1.0;
+			}
+		};
+
+		Animation xform_anim;
+		Transform2D xform_anim_from;
+		Transform2D xform_anim_to;
+		Animation modulate_anim;
+		Color modulate_anim_from;
+		Color modulate_anim_to;
+		SelfList<Item> animation_list;
+
+		Item() :
+				animation_list(this) {
+			redrawing = false;
+			redraw_prev_hash_valid = false;
+			redraw_prev_hash = 0;
+			redraw_prev_rect_valid = false;
+			redraw_changes = 0;
+			redraw_frame = 0;
 			children_order_dirty = true;
 			E = NULL;
 			z_index = 0;
@@ -146,7 +188,28 @@ public:
 	RID_Owner<Item> canvas_item_owner;
 	RID_Owner<RasterizerCanvas::Light> canvas_light_owner;
 
+	SelfList<Item>::List animated_items;
+
 private:
+	enum {
+		TRIANGULATION_CACHE_MAX = 512
+	};
+
+	// canvas_item_add_polygon() results keyed by a hash of the points, so
+	// redrawing an unchanged polygon skips triangulation. Entries live in two
+	// generations, when the current one fills up the previous one is dropped
+	// and anything still in use gets moved over on its next hit.
+	struct TriangulationCache {
+		Vector<Point2> points;
+		Vector<int> indices;
+	};
+
+	HashMap<uint32_t, TriangulationCache> triangulation_cache[2];
+	int triangulation_cache_current;
+	Mutex *triangulation_cache_mutex;
+
+	Vector<int> _triangulate_polygon(const Vector<Point2> &p_points);
+
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
@@ -181,6 +244,7 @@ public:
 	void canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile = false, const Color &p_modulate = Color(1, 1, 1), bool p_transpose = false, RID p_normal_map = RID());
 	void canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate = Color(1, 1, 1), bool p_transpose = false, RID p_normal_map = RID(), bool p_clip_uv = false);
 	void canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, VS::NinePatchAxisMode p_x_axis_mode = VS::NINE_PATCH_STRETCH, VS::NinePatchAxisMode p_y_axis_mode = VS::NINE_PATCH_STRETCH, bool p_draw_center = true, const Color &p_modulate = Color(1, 1, 1), RID p_normal_map = RID());
+	void canvas_item_add_style_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, const Vector2 &p_border_topleft, const Vector2 &p_border_bottomright, const Color &p_border_color, const Vector2 &p_corner_radius_top = Vector2(), const Vector2 &p_corner_radius_bottom = Vector2(), const Color &p_shadow_color = Color(0, 0, 0, 0), float p_shadow_size = 0, float p_aa_size = 0);
 	void canvas_item_add_primitive(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, float p_width = 1.0, RID p_normal_map = RID());
 	void canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), RID p_texture = RID(), RID p_normal_map = RID(), bool p_antialiased = false);
 	void canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), RID p_texture = RID(), int p_count = -1, RID p_normal_map = RID());
@@ -195,7 +259,12 @@ public:
 	void canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect);
 	void canvas_item_attach_skeleton(RID p_item, RID p_skeleton);
 
-	void canvas_item_clear(RID p_item);
+	void canvas_item_animate_transform(RID p_item, const Transform2D &p_from, const Transform2D &p_to, float p_duration, float p_easing = 1.0);
+	void canvas_item_animate_modulate(RID p_item, const Color &p_from, const Color &p_to, float p_duration, float p_easing = 1.0);
+	void canvas_item_stop_animations(RID p_item);
+
+	void canvas_item_clear(RID p_item, uint32_t p_changes = 0, uint32_t p_frame = 0);
+	bool canvas_item_end_draw(RID p_item, int *r_command_count = NULL, uint32_t *r_changes = NULL, uint32_t *r_frame = NULL);
 	void canvas_item_set_draw_index(RID p_item, int p_index);
 
 	void canvas_item_set_material(RID p_item, RID p_material);
@@ -239,8 +308,11 @@ public:
 
 	void canvas_occluder_polygon_set_cull_mode(RID p_occluder_polygon, VS::CanvasOccluderPolygonCullMode p_mode);
 
+	bool update_animations();
+
 	bool free(RID p_rid);
 	VisualServerCanvas();
+	~VisualServerCanvas();
 };
 
 #endif // VISUALSERVERCANVAS_H
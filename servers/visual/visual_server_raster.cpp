@@ -33,6 +33,7 @@
 #include "default_mouse_cursor.xpm"
 #include "io/marshalls.h"
 #include "os/os.h"
+#include "profiler.h"
 #include "project_settings.h"
 #include "sort.h"
 #include "visual_server_canvas.h"
@@ -41,7 +42,7 @@
 
 // careful, these may run in different threads than the visual server
 
-int VisualServerRaster::changes = 0;
+uint32_t VisualServerRaster::changes = 0;
 
 /* BLACK BARS */
 
@@ -95,7 +96,17 @@ void VisualServerRaster::request_frame_drawn_callback(Object *p_where, const Str
 
 void VisualServerRaster::draw(bool p_swap_buffers) {
 
+	PROFILE_SCOPE("VisualServerRaster::draw");
+
 	changes = 0;
+	frames_drawn++;
+
+	canvas_command_allocations = RasterizerCanvas::command_allocations;
+	RasterizerCanvas::command_allocations = 0;
+
+	// stepped on every draw, with a render thread it also draws them while the main thread is busy
+	if (VSG::canvas->update_animations())
+		redraw_request(); // keep drawing until they finish
 
 	VSG::rasterizer->begin_frame();
 
@@ -145,8 +156,34 @@ void VisualServerRaster::finish() {
 
 /* STATUS INFORMATION */
 
+void VisualServerRaster::canvas_item_clear(RID p_item) {
+
+	VSG::canvas->canvas_item_clear(p_item, changes, frames_drawn);
+	redraw_request();
+}
+
+void VisualServerRaster::canvas_item_end_draw(RID p_item) {
+
+	int command_count = 0;
+	uint32_t clear_changes = 0;
+	uint32_t clear_frame = 0;
+	if (VSG::canvas->canvas_item_end_draw(p_item, &command_count, &clear_changes, &clear_frame))
+		return;
+
+	// The clear and every command added to this item since flagged a change.
+	// The redraw was a no-op, so take back exactly those, leaving whatever
+	// other items flagged in between. Not if a draw reset the counter since.
+	uint32_t own_changes = 1 + command_count;
+	if (clear_frame == frames_drawn && changes - clear_changes >= own_changes) {
+		atomic_sub(&changes, own_changes);
+	}
+}
+
 int VisualServerRaster::get_render_info(RenderInfo p_info) {
 
+	if (p_info == INFO_2D_COMMAND_ALLOCATIONS_IN_FRAME)
+		return canvas_command_allocations;
+
 	return VSG::storage->get_render_info(p_info);
 }
 
@@ -188,6 +225,9 @@ void VisualServerRaster::call_set_use_vsync(bool p_enable) {
 
 VisualServerRaster::VisualServerRaster() {
 
+	canvas_command_allocations = 0;
+	frames_drawn = 0;
+
 	VSG::canvas = memnew(VisualServerCanvas);
 	VSG::viewport = memnew(VisualServerViewport);
 	VSG::scene = memnew(VisualServerScene);
@@ -33,6 +33,7 @@
 
 #include "allocators.h"
 #include "octree.h"
+#include "safe_refcount.h"
 #include "servers/visual/rasterizer.h"
 #include "servers/visual_server.h"
 #include "visual_server_canvas.h"
@@ -58,7 +59,9 @@ class VisualServerRaster : public VisualServer {
 
 	};
 
-	static int changes;
+	static uint32_t changes;
+	int canvas_command_allocations;
+	uint32_t frames_drawn; // tells canvas_item_end_draw() whether changes was reset since the clear
 	bool draw_extra_frame;
 	RID test_cube;
 
@@ -83,19 +86,20 @@ public:
 
 #ifdef DEBUG_CHANGES
 	_FORCE_INLINE_ static void redraw_request() {
-		changes++;
+		atomic_increment(&changes);
 		_changes_changed();
 	}
 
-#define DISPLAY_CHANGED \
-	changes++;          \
+#define DISPLAY_CHANGED         \
+	atomic_increment(&changes); \
 	_changes_changed();
 
 #else
-	_FORCE_INLINE_ static void redraw_request() { changes++; }
+	//canvas items can be drawn from several threads at once, so count atomically
+	_FORCE_INLINE_ static void redraw_request() { atomic_increment(&changes); }
 
 #define DISPLAY_CHANGED \
-	changes++;
+	atomic_increment(&changes);
 #endif
 
 #define BIND0R(m_r, m_name) \
@@ -577,6 +581,7 @@ public:
 	BIND7(canvas_item_add_texture_rect, RID, const Rect2 &, RID, bool, const Color &, bool, RID)
 	BIND8(canvas_item_add_texture_rect_region, RID, const Rect2 &, RID, const Rect2 &, const Color &, bool, RID, bool)
 	BIND11(canvas_item_add_nine_patch, RID, const Rect2 &, const Rect2 &, RID, const Vector2 &, const Vector2 &, NinePatchAxisMode, NinePatchAxisMode, bool, const Color &, RID)
+	BIND11(canvas_item_add_style_rect, RID, const Rect2 &, const Color &, const Vector2 &, const Vector2 &, const Color &, const Vector2 &, const Vector2 &, const Color &, float, float)
 	BIND7(canvas_item_add_primitive, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, float, RID)
 	BIND7(canvas_item_add_polygon, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, RID, bool)
 	BIND8(canvas_item_add_triangle_array, RID, const Vector<int> &, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, int, RID)
@@ -591,7 +596,14 @@ public:
 	BIND3(canvas_item_set_copy_to_backbuffer, RID, bool, const Rect2 &)
 	BIND2(canvas_item_attach_skeleton, RID, RID)
 
-	BIND1(canvas_item_clear, RID)
+	BIND5(canvas_item_animate_transform, RID, const Transform2D &, const Transform2D &, float, float)
+	BIND5(canvas_item_animate_modulate, RID, const Color &, const Color &, float, float)
+	BIND1(canvas_item_stop_animations, RID)
+
+	// not bound through the macros, they only flag a change when the
+	// commands recorded in between actually differ
+	virtual void canvas_item_clear(RID p_item);
+	virtual void canvas_item_end_draw(RID p_item);
 	BIND2(canvas_item_set_draw_index, RID, int)
 
 	BIND2(canvas_item_set_material, RID, RID)
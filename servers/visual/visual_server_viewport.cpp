@@ -30,6 +30,7 @@
 
 #include "visual_server_viewport.h"
 
+#include "profiler.h"
 #include "project_settings.h"
 #include "visual_server_canvas.h"
 #include "visual_server_global.h"
@@ -231,6 +232,8 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport) {
 }
 
 void VisualServerViewport::draw_viewports() {
+	PROFILE_SCOPE("VisualServerViewport::draw_viewports");
+
 	clear_color = GLOBAL_GET("rendering/environment/default_clear_color");
 
 	//sort viewports
@@ -42,7 +42,9 @@ void VisualServerWrapMT::thread_draw() {
 	if (!atomic_decrement(&draw_pending)) {
 
 		visual_server->draw();
+		last_draw_usec = OS::get_singleton()->get_ticks_usec();
 	}
+	frame_open = false;
 }
 
 void VisualServerWrapMT::thread_flush() {
@@ -68,7 +70,23 @@ void VisualServerWrapMT::thread_loop() {
 	exit = false;
 	draw_thread_up = true;
 	while (!exit) {
+
+		if (!frame_open && visual_server->has_changed() && command_queue.is_empty()) {
+			// The main thread sent nothing since its last frame, so drawing shows no half
+			// updated state. The server still wants frames, e.g. for canvas item animations,
+			// so draw them here instead of waiting for a main thread that is busy elsewhere.
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+			if (ticks - last_draw_usec >= SELF_DRAW_INTERVAL_USEC) {
+				visual_server->draw();
+				last_draw_usec = ticks;
+			} else {
+				OS::get_singleton()->delay_usec(1000);
+			}
+			continue;
+		}
+
 		// flush commands one by one, until exit is requested
+		frame_open = true; // cleared again if the command is a draw
 		command_queue.wait_and_flush_one();
 	}
 
@@ -177,6 +195,8 @@ VisualServerWrapMT::VisualServerWrapMT(VisualServer *p_contained, bool p_create_
 	create_thread = p_create_thread;
 	thread = NULL;
 	draw_pending = 0;
+	frame_open = true;
+	last_draw_usec = 0;
 	draw_thread_up = false;
 	alloc_mutex = Mutex::create();
 	pool_max_size = GLOBAL_GET("memory/limits/multithreaded_server/rid_pool_prealloc");
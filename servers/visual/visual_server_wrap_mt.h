@@ -40,6 +40,10 @@
 */
 class VisualServerWrapMT : public VisualServer {
 
+	enum {
+		SELF_DRAW_INTERVAL_USEC = 16666 // frames drawn without the main thread asking, about 60 per second
+	};
+
 	// the real visual server
 	mutable VisualServer *visual_server;
 
@@ -55,6 +59,8 @@ class VisualServerWrapMT : public VisualServer {
 	bool create_thread;
 
 	uint64_t draw_pending;
+	bool frame_open; // commands arrived since the last draw the main thread asked for
+	uint64_t last_draw_usec;
 	void thread_draw();
 	void thread_flush();
 
@@ -494,6 +500,7 @@ public:
 	FUNC7(canvas_item_add_texture_rect, RID, const Rect2 &, RID, bool, const Color &, bool, RID)
 	FUNC8(canvas_item_add_texture_rect_region, RID, const Rect2 &, RID, const Rect2 &, const Color &, bool, RID, bool)
 	FUNC11(canvas_item_add_nine_patch, RID, const Rect2 &, const Rect2 &, RID, const Vector2 &, const Vector2 &, NinePatchAxisMode, NinePatchAxisMode, bool, const Color &, RID)
+	FUNC11(canvas_item_add_style_rect, RID, const Rect2 &, const Color &, const Vector2 &, const Vector2 &, const Color &, const Vector2 &, const Vector2 &, const Color &, float, float)
 	FUNC7(canvas_item_add_primitive, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, float, RID)
 	FUNC7(canvas_item_add_polygon, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, RID, bool)
 	FUNC8(canvas_item_add_triangle_array, RID, const Vector<int> &, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, int, RID)
@@ -508,7 +515,12 @@ public:
 	FUNC3(canvas_item_set_copy_to_backbuffer, RID, bool, const Rect2 &)
 	FUNC2(canvas_item_attach_skeleton, RID, RID)
 
+	FUNC5(canvas_item_animate_transform, RID, const Transform2D &, const Transform2D &, float, float)
+	FUNC5(canvas_item_animate_modulate, RID, const Color &, const Color &, float, float)
+	FUNC1(canvas_item_stop_animations, RID)
+
 	FUNC1(canvas_item_clear, RID)
+	FUNC1(canvas_item_end_draw, RID)
 	FUNC2(canvas_item_set_draw_index, RID, int)
 
 	FUNC2(canvas_item_set_material, RID, RID)
@@ -842,6 +842,7 @@ public:
 	virtual void canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile = false, const Color &p_modulate = Color(1, 1, 1), bool p_transpose = false, RID p_normal_map = RID()) = 0;
 	virtual void canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate = Color(1, 1, 1), bool p_transpose = false, RID p_normal_map = RID(), bool p_clip_uv = false) = 0;
 	virtual void canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, NinePatchAxisMode p_x_axis_mode = NINE_PATCH_STRETCH, NinePatchAxisMode p_y_axis_mode = NINE_PATCH_STRETCH, bool p_draw_center = true, const Color &p_modulate = Color(1, 1, 1), RID p_normal_map = RID()) = 0;
+	virtual void canvas_item_add_style_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, const Vector2 &p_border_topleft, const Vector2 &p_border_bottomright, const Color &p_border_color, const Vector2 &p_corner_radius_top = Vector2(), const Vector2 &p_corner_radius_bottom = Vector2(), const Color &p_shadow_color = Color(0, 0, 0, 0), float p_shadow_size = 0, float p_aa_size = 0) = 0;
 	virtual void canvas_item_add_primitive(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, float p_width = 1.0, RID p_normal_map = RID()) = 0;
 	virtual void canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), RID p_texture = RID(), RID p_normal_map = RID(), bool p_antialiased = false) = 0;
 	virtual void canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), RID p_texture = RID(), int p_count = -1, RID p_normal_map = RID()) = 0;
@@ -857,7 +858,12 @@ public:
 
 	virtual void canvas_item_attach_skeleton(RID p_item, RID p_skeleton) = 0;
 
+	virtual void canvas_item_animate_transform(RID p_item, const Transform2D &p_from, const Transform2D &p_to, float p_duration, float p_easing = 1.0) = 0;
+	virtual void canvas_item_animate_modulate(RID p_item, const Color &p_from, const Color &p_to, float p_duration, float p_easing = 1.0) = 0;
+	virtual void canvas_item_stop_animations(RID p_item) = 0;
+
 	virtual void canvas_item_clear(RID p_item) = 0;
+	virtual void canvas_item_end_draw(RID p_item) = 0;
 	virtual void canvas_item_set_draw_index(RID p_item, int p_index) = 0;
 
 	virtual void canvas_item_set_material(RID p_item, RID p_material) = 0;
@@ -955,6 +961,9 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_2D_COMMAND_ALLOCATIONS_IN_FRAME,
+		INFO_TEXTURE_MEM_EVICTED,
+		INFO_TEXTURES_RESTREAMED_IN_FRAME,
 	};
 
 	virtual int get_render_info(RenderInfo p_info) = 0;